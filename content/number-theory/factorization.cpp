@@ -2,9 +2,14 @@
  * Author: Boboge adapted from Yuhao Yao
  * Date: 23-02-08
  * Description: Primality test and Fast Factorization. The $mul$ function supports $0 \le a, b < c < 7.268 \times 10^{18}$ and is a little bit faster than \_\_int128.
+ *  $miller$ is $is\_prime$; $pollard$ runs on $Montgomery64$ (both from is-prime.cpp).
+ *  $factorize$ first divides out $2$ and the odd primes below $1000$ (divisibility by $p$ is $n p^{-1} \bmod 2^{64} \le \lfloor (2^{64} - 1) / p \rfloor$), then runs Brent's rho ($f(x) = x^2 + c$, $c = 1, 2, \dots$, so it is deterministic) with one $gcd$ per $128$ steps.
+ *  $factorize\_batch$ factors many numbers over $threads$.
  * Time: O(x ^ {1 / 4}) for pollard-rho and same for factorizing $x$.
  * Status: tested on https://judge.yosupo.jp/problem/factorize, https://qoj.ac/contest/821/problem/2574.
  */
+#include "is-prime.cpp"
+
 namespace Factorization {
     template<class T>
     constexpr int ctz(T x) { return sizeof(T) & 8 ? __builtin_ctzll(x) : __builtin_ctz(x); }
@@ -23,7 +28,7 @@ namespace Factorization {
         }
     }
 
-    inline i64 mul(i64 a, i64 b, i64 c) { /// start-hash
+    inline i64 mul(i64 a, i64 b, i64 c) {
         return (i128) a * b % c;
     }
 
@@ -33,50 +38,64 @@ namespace Factorization {
         return res;
     }
 
-    bool miller(i64 n) {
-        auto test = [&](i64 n, int a) {
-            if (n == a) return true;
-            if (n % 2 == 0) return false;
-            i64 d = (n - 1) >> ctz(n - 1);
-            i64 r = mPow(a, d, n);
-            while (d < n - 1 && r != 1 && r != n - 1) {
-                d <<= 1;
-                r = mul(r, r, n);
-            }
-            return r == n - 1 || d & 1;
-        };
-
-        if (n == 2) return 1;
-        for (int p: {2, 3, 5, 7, 11, 13, 17, 23, 29}) if (test(n, p) == 0) return 0;
-        return 1;
-    } /// end-hash
+    bool miller(i64 n) { return n >= 0 && is_prime(n); }
 
-    mt19937_64 rng(chrono::steady_clock::now().time_since_epoch().count());
-    i64 myrand(i64 a, i64 b) { return uniform_int_distribution<i64>(a, b)(rng); }
+    // Some divisor of odd composite n, n itself if this c fails.
+    u64 rho(const Montgomery64 &M, u64 c) { /// start-hash
+        u64 n = M.n, x = 0, y = M.to(2), ys = y, q = M.one, g = 1;
+        auto f = [&](u64 v) { return M.add(M.mul(v, v), c); };
+        for (u64 r = 1; g == 1; r <<= 1) {
+            x = y;
+            for (u64 i = 0; i < r; ++i) y = f(y);
+            for (u64 k = 0; k < r && g == 1; k += 128) {
+                ys = y;
+                for (u64 i = 0; i < min<u64>(128, r - k); ++i) y = f(y), q = M.mul(q, x > y ? x - y : y - x);
+                g = gcd(q, n);
+            }
+        }
+        if (g == n) do ys = f(ys), g = gcd(x > ys ? x - ys : ys - x, n); while (g == 1);
+        return g;
+    }
 
     i64 pollard(i64 n) { // return some nontrivial factor of n.
-        if (miller(n)) return n;
         if (n % 2 == 0) return 2;
-        i64 st = 0;
-        auto f = [&](i64 x) { return (__int128_t(x) * x + st) % n; };
-        while (true) {
-            st++;
-            i64 x = st, y = f(x);
-            while (true) {
-                i64 p = gcd((y - x + n), n);
-                if (p == 0 || p == n) break;
-                if (p != 1) return p;
-                x = f(x);
-                y = f(f(y));
-            }
+        if (miller(n)) return n;
+        Montgomery64 M(n);
+        for (u64 c = 1;; ++c) {
+            u64 g = rho(M, M.to(c));
+            if (g != (u64) n) return g;
         }
+    } /// end-hash
+
+    struct Trial { u64 p, inv, lim; };
+    const vector<Trial> &smallPrimes() {
+        static const vector<Trial> ps = [] {
+            vector<Trial> v;
+            for (u64 p = 3; p < 1000; p += 2) {
+                bool ok = 1;
+                for (u64 q = 3; q * q <= p; q += 2) ok &= p % q != 0;
+                if (!ok) continue;
+                u64 inv = p;
+                for (int i = 0; i < 5; ++i) inv *= 2 - p * inv;
+                v.push_back({p, inv, ~0ull / p});
+            }
+            return v;
+        }();
+        return ps;
     }
 
-    vector<i64> factorize(i64 n) {
+    vector<i64> factorize(i64 n) { /// start-hash
         vector<i64> res;
+        if (n <= 1) return res;
+        int k = ctz(n);
+        res.assign(k, 2), n >>= k;
+        for (auto &[p, inv, lim]: smallPrimes()) {
+            if ((u64) n < p * p) break;
+            for (u64 q; (q = (u64) n * inv) <= lim; n = q) res.push_back(p);
+        }
         auto dfs = [&](auto &dfs, i64 x) {
             if (x == 1) return;
-            if (miller(x)) res.push_back(x);
+            if (x < 1000000 || miller(x)) res.push_back(x); // no prime factor below 1000 left.
             else {
                 i64 d = pollard(x);
                 dfs(dfs, d);
@@ -84,7 +103,20 @@ namespace Factorization {
             }
         };
         dfs(dfs, n);
-		sort(res.begin(), res.end());
+        sort(res.begin(), res.end());
+        return res;
+    }
+
+    vector<vector<i64>> factorize_batch(const vector<i64> &ns, int threads = 1) {
+        vector<vector<i64>> res(sz(ns));
+        atomic<int> next{0};
+        auto work = [&] {
+            for (int i; (i = next++) < sz(ns);) res[i] = factorize(ns[i]);
+        };
+        vector<thread> ts;
+        for (int t = 1; t < threads; ++t) ts.emplace_back(work);
+        work();
+        for (auto &t: ts) t.join();
         return res;
     } /// end-hash
-}
\ No newline at end of file
+}
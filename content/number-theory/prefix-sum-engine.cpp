@@ -0,0 +1,120 @@
+/**
+ * Author: Boboge
+ * Date: 26-10-17
+ * Description: $\sum_{i \le n} f(i)$ for a multiplicative $f$ by Lucy-Hedgehog and Min\_25, $n \le 10^{11}$ or so, over $T$ = $i128$ or $mint$ (needs $/2$, $/6$).
+ *  $f$ is given by $pk(p, k) = f(p^k)$ and, on primes, by a polynomial $f(p) = \sum_{e \le 2} coef_e p^e$.
+ *  $prime(e)[j] = \sum_{p \le vs[j], p \text{ prime}} p^e$ for the $O(\sqrt n)$ values $vs = \{\lfloor n / i \rfloor\}$; each sieving prime updates the values $\ge p^2$, in parallel through a second buffer (reads all finish before writes).
+ *  $sum$ then runs the Min\_25 recursion over the smallest prime factor, the branches of the sieving primes (from $LinearSieve$ up to $\sqrt n$) split over $threads$.
+ * Usage:
+ *  PrefixSumEngine<i128> e(n, 4);
+ *  i128 pi = e.primeCount(), phi = e.phiSum(), mu = e.muSum();
+ * Time: O(n^{3 / 4} / \log n).
+ * Status: checked against $LinearSieve$ up to $2 \cdot 10^6$ and $\pi(10^{11}) = 4118054813$.
+ */
+#include "sieve.cpp"
+
+template<class T>
+struct PrefixSumEngine {
+    u64 n;
+    int sq, threads;
+    vector<u64> vs; // n / i, decreasing.
+    vi id1, id2;
+    vector<unsigned> ps;
+    map<int, vector<T>> g;
+
+    PrefixSumEngine(u64 n, int threads = 1) : n(n), threads(threads) { /// start-hash
+        sq = sqrtl(n);
+        while ((u64) sq * sq > n) --sq;
+        while ((u64) (sq + 1) * (sq + 1) <= n) ++sq;
+        id1.resize(sq + 2), id2.resize(sq + 2);
+        for (u64 i = 1; i <= n; i = n / (n / i) + 1) {
+            u64 v = n / i;
+            (v <= (u64) sq ? id1[v] : id2[n / v]) = sz(vs);
+            vs.push_back(v);
+        }
+        ps = LinearSieve<>(sq + 1).ps;
+    }
+
+    int idx(u64 v) const { return v <= (u64) sq ? id1[v] : id2[n / v]; }
+
+    // Runs f(l, r) over [0, len) in threads pieces when len is large.
+    template<class F>
+    void split(int len, F f) {
+        int th = len < (1 << 16) ? 1 : threads;
+        vector<thread> ts;
+        for (int t = 1; t < th; ++t) ts.emplace_back(f, (i64) len * t / th, (i64) len * (t + 1) / th);
+        f(0, len / th);
+        for (auto &t: ts) t.join();
+    }
+
+    const vector<T> &prime(int e) {
+        if (g.count(e)) return g[e];
+        vector<T> G(sz(vs)), D(sz(vs));
+        for (int j = 0; j < sz(vs); ++j) {
+            T a = vs[j], b = vs[j] + 1, c = vs[j] * 2 + 1; // \sum_{2 \le i \le v} i^e.
+            G[j] = (e == 0 ? a : e == 1 ? a * b / 2 : a * b * c / 6) - 1;
+        }
+        for (unsigned p: ps) {
+            if ((u64) p * p > n) break;
+            T pe = e == 0 ? T(1) : e == 1 ? T(p) : T(p) * p;
+            int lim = 0, q = idx(p - 1);
+            while (lim < sz(vs) && vs[lim] >= (u64) p * p) ++lim;
+            T gq = G[q];
+            split(lim, [&](int l, int r) { for (int j = l; j < r; ++j) D[j] = pe * (G[idx(vs[j] / p)] - gq); });
+            split(lim, [&](int l, int r) { for (int j = l; j < r; ++j) G[j] -= D[j]; });
+        }
+        return g[e] = G;
+    } /// end-hash
+
+    template<class F>
+    T sum(F pk, const vector<T> &coef) { /// start-hash
+        vector<T> fp(sz(vs)), pre{0}; // fp[j] = \sum_{p \le vs[j]} f(p), pre[k] = \sum_{i < k} f(ps[i]).
+        for (int e = 0; e < sz(coef); ++e) {
+            auto &G = prime(e);
+            for (int j = 0; j < sz(vs); ++j) fp[j] += coef[e] * G[j];
+        }
+        for (unsigned p: ps) pre.push_back(pre.back() + pk(p, 1));
+        // f(ps[i]^e m) for ps[i]^e m <= x, e >= 1 and spf(m) > ps[i] (m = 1 only if e >= 2).
+        auto branch = [&](auto &S, u64 x, int i) -> T {
+            T res = 0;
+            u64 p = ps[i], pe = p;
+            for (int e = 1; pe * p <= x; ++e, pe *= p) res += S(S, x / pe, i + 1) * pk(p, e) + pk(p, e + 1);
+            return res;
+        };
+        // \sum f(i) over 2 \le i \le x with spf(i) >= ps[k].
+        auto S = [&](auto &self, u64 x, int k) -> T {
+            if (k < sz(ps) && ps[k] > x) return 0;
+            T res = fp[idx(x)] - pre[k];
+            for (int i = k; i < sz(ps) && (u64) ps[i] * ps[i] <= x; ++i) res += branch(self, x, i);
+            return res;
+        };
+        int K = 0;
+        while (K < sz(ps) && (u64) ps[K] * ps[K] <= n) ++K;
+        vector<T> part(threads);
+        atomic<int> next{0};
+        auto work = [&](int t) {
+            for (int i; (i = next++) < K;) part[t] += branch(S, n, i);
+        };
+        vector<thread> ts;
+        for (int t = 1; t < threads; ++t) ts.emplace_back(work, t);
+        work(0);
+        for (auto &t: ts) t.join();
+        T res = 1 + fp[0];
+        for (auto &x: part) res += x;
+        return res;
+    } /// end-hash
+
+    T primeCount() { return prime(0)[0]; }
+
+    T phiSum() {
+        return sum([](u64 p, int k) {
+            T r = p - 1;
+            while (--k) r *= p;
+            return r;
+        }, {T(-1), T(1)});
+    }
+
+    T muSum() {
+        return sum([](u64, int k) { return T(k == 1 ? -1 : 0); }, {T(-1)});
+    }
+};
@@ -0,0 +1,113 @@
+/**
+ * Author: Boboge
+ * Date: 26-10-17
+ * Description: Segmented sieve of Eratosthenes for primes up to $n \le 10^{12}$ in $O(\sqrt n)$ memory.
+ *  Mod-$30$ wheel: byte $i$ holds the $8$ numbers $30 i + \{1, 7, 11, 13, 17, 19, 23, 29\}$. For a prime $p$ the multiples $p m$ with $m \equiv r \pmod{30}$ always hit the same bit and are $p$ bytes apart, so each prime keeps $8$ byte offsets that carry over from one segment ($2^{18}$ bytes, about L2) to the next.
+ *  $count(threads)$ is $\pi(n)$, the segments cut into $threads$ contiguous blocks. $forEach(f)$ calls $f(p)$ for all primes $p \le n$ in order.
+ * Usage:
+ *  SegmentedSieve s(1e10);
+ *  u64 c = s.count(8);
+ *  s.forEach([&](u64 p) { ... });
+ * Time: O(n \log \log n).
+ * Status: checked against $LinearSieve$ for $n \le 10^7$ and $\pi(10^{10}) = 455052511$.
+ */
+struct SegmentedSieve {
+    static constexpr int S = 1 << 18;
+    static constexpr int R[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+    u64 n;
+    vector<unsigned> ps; // primes in [7, \sqrt n].
+    vector<uint8_t> mk, pre; // mk[8 i + k]: the bit hit by ps[i] * (30 j + R[k]); pre: period of 7, 11, 13, 17 crossed off.
+    int i0 = 0; // ps[i] <= 17 for i < i0, handled by pre.
+
+    SegmentedSieve(u64 n) : n(n) { /// start-hash
+        unsigned r = sqrtl(n);
+        while ((u64) r * r > n) --r;
+        while ((u64) (r + 1) * (r + 1) <= n) ++r;
+        vector<char> c(r + 1);
+        int pos[30]{};
+        for (int k = 0; k < 8; ++k) pos[R[k]] = k;
+        for (unsigned i = 2; i <= r; ++i) if (!c[i]) {
+            for (u64 j = (u64) i * i; j <= r; j += i) c[j] = 1;
+            if (i <= 5) continue;
+            ps.push_back(i), i0 += i <= 17;
+            for (int k = 0; k < 8; ++k) mk.push_back(1 << pos[i * R[k] % 30]);
+        }
+        pre.assign(7 * 11 * 13 * 17, 0xff);
+        for (int j = 0; j < sz(pre); ++j)
+            for (int k = 0; k < 8; ++k) {
+                int v = (j * 30 + R[k]) % 510510;
+                if (v % 7 == 0 || v % 11 == 0 || v % 13 == 0 || v % 17 == 0) pre[j] &= ~(1 << k);
+            }
+    }
+
+    // Offsets (in bytes from b0) of the first multiple p m >= max(p^2, 30 b0) in each class.
+    void start(u64 b0, vector<u64> &at) const {
+        at.resize(sz(ps) * 8);
+        for (int i = 0; i < sz(ps); ++i) {
+            u64 p = ps[i], m0 = max(p, (b0 * 30 + p - 1) / p);
+            for (int k = 0; k < 8; ++k) {
+                u64 m = m0 + (R[k] + 30 - m0 % 30) % 30;
+                at[i * 8 + k] = p * m / 30 - b0;
+            }
+        }
+    }
+
+    // Sieve bytes [b0, b0 + len) into seg; a set bit is a prime <= n.
+    void sieve(u64 b0, int len, uint8_t *seg, vector<u64> &at) const {
+        for (int j = 0, o = b0 % sz(pre); j < len;) {
+            int c = min(len - j, sz(pre) - o);
+            memcpy(seg + j, &pre[o], c), j += c, o = 0;
+        }
+        if (b0 == 0) seg[0] = (seg[0] & ~1) | 0x1e; // 1 is not prime, 7, 11, 13, 17 are.
+        for (int i = i0; i < sz(ps); ++i) {
+            unsigned p = ps[i];
+            for (int k = 0; k < 8; ++k) {
+                u64 j = at[i * 8 + k];
+                uint8_t m = ~mk[i * 8 + k];
+                for (; j < (u64) len; j += p) seg[j] &= m;
+                at[i * 8 + k] = j - len;
+            }
+        }
+        if (b0 + len > n / 30) // clear the numbers above n.
+            for (int k = 0; k < 8; ++k) if (n / 30 * 30 + R[k] > n) seg[n / 30 - b0] &= ~(1 << k);
+    } /// end-hash
+
+    u64 count(int threads = 1) { /// start-hash
+        u64 B = n / 30 + 1, cnt = (B + S - 1) / S, res = (n >= 2) + (n >= 3) + (n >= 5);
+        vector<u64> part(threads);
+        auto work = [&](int t) {
+            vector<uint8_t> seg(S);
+            vector<u64> at;
+            u64 lo = cnt * t / threads, hi = cnt * (t + 1) / threads;
+            if (lo < hi) start(lo * S, at);
+            for (u64 s = lo; s < hi; ++s) {
+                int len = min<u64>(S, B - s * S);
+                sieve(s * S, len, seg.data(), at);
+                int j = 0;
+                for (u64 w; j + 8 <= len; j += 8) memcpy(&w, &seg[j], 8), part[t] += __builtin_popcountll(w);
+                for (; j < len; ++j) part[t] += __builtin_popcount(seg[j]);
+            }
+        };
+        vector<thread> ts;
+        for (int t = 1; t < threads; ++t) ts.emplace_back(work, t);
+        work(0);
+        for (auto &t: ts) t.join();
+        for (auto x: part) res += x;
+        return res;
+    }
+
+    template<class F>
+    void forEach(F f) {
+        for (u64 p: {2, 3, 5}) if (p <= n) f(p);
+        u64 B = n / 30 + 1;
+        vector<uint8_t> seg(S);
+        vector<u64> at;
+        start(0, at);
+        for (u64 b0 = 0; b0 < B; b0 += S) {
+            int len = min<u64>(S, B - b0);
+            sieve(b0, len, seg.data(), at);
+            for (int j = 0; j < len; ++j)
+                for (int x = seg[j]; x; x &= x - 1) f((b0 + j) * 30 + R[__builtin_ctz(x)]);
+        }
+    } /// end-hash
+};
@@ -2,40 +2,99 @@
  * Author: Boboge adapted from Yuhao Yao
  * Date: 23-02-08
  * Description: Sieve for prime numbers / multiplicative functions in $\{1, 2, ..., N\}$ in linear time.
- * Time: O(N).
+ *  Every $F$ in $Fs$ is a multiplicative function given by $F::pk(p, k) = F(p^k)$, $F::combine$ (the product of values at coprime arguments) and $F::one = F(1)$; only its table $get<F>()$ (of $F::type$) is stored.
+ *  Without any $F$ only $spf$ (smallest prime factor) and $ps$ are kept; otherwise also $lpk[i]$, the power of $spf[i]$ in $i$, so that $F(i) = combine(F(i / lpk[i]), F(lpk[i]))$.
+ *  $range<F>(L, R)$ gives $F$ on $[L, R]$ for $1 \le L$, $R \le N^2$, with $O(R - L)$ memory; call it on blocks for longer ranges.
+ * Usage:
+ *  LinearSieve<Phi<>, Mu> s(n); auto &mu = s.get<Mu>();
+ *  auto phi = s.range<Phi<u64>>(L, R);
+ * Time: O(N), and O((R - L) \log \log R + \pi(\sqrt R)) for $range$.
  * Status: tested on https://official.contest.yandex.com/opencupXXII/contest/37831/problems/B/.
  */
+#pragma once
+
+template<class T = unsigned>
+struct Phi {
+    using type = T;
+    static constexpr T one = 1;
+    static T pk(u64 p, int k) {
+        T r = p - 1;
+        while (--k) r *= p;
+        return r;
+    }
+    static T combine(T a, T b) { return a * b; }
+};
+
+struct Mu {
+    using type = int8_t;
+    static constexpr type one = 1;
+    static type pk(u64, int k) { return k == 1 ? -1 : 0; }
+    static type combine(type a, type b) { return a * b; }
+};
+
+struct DivCount { // fits in 16 bits for arguments below 10^{17}.
+    using type = uint16_t;
+    static constexpr type one = 1;
+    static type pk(u64, int k) { return k + 1; }
+    static type combine(type a, type b) { return a * b; }
+};
+
+template<class... Fs>
 struct LinearSieve {
-    vector<int> ps, mark;
-    vector<int> d, facnum, phi, mu;
-	
-    LinearSieve(int n) : mark(n + 1), d(n + 1), facnum(n + 1), phi(n + 1), mu(n + 1) {
-        facnum[1] = phi[1] = mu[1] = 1;
-        for (int i = 2; i <= n; ++i) {
-            if (mark[i] == 0) {
-                ps.push_back(i);
-                mark[i] = i;
-                d[i] = 1;
-                facnum[i] = 2;
-                phi[i] = i - 1;
-                mu[i] = -1;
+    vector<unsigned> ps, spf, lpk; /// start-hash
+    tuple<vector<typename Fs::type>...> tab;
+
+    template<size_t I = 0>
+    void calc(unsigned i, int k) {
+        if constexpr (I < sizeof...(Fs)) {
+            using F = tuple_element_t<I, tuple<Fs...>>;
+            auto &v = std::get<I>(tab);
+            v[i] = i == 1 ? F::one : lpk[i] == i ? F::pk(spf[i], k) : F::combine(v[i / lpk[i]], v[lpk[i]]);
+            calc<I + 1>(i, k);
+        }
+    }
+
+    LinearSieve(unsigned n) : spf(n + 1) {
+        constexpr bool mul = sizeof...(Fs) > 0;
+        if constexpr (mul) lpk.resize(n + 1), apply([&](auto &...v) { (v.resize(n + 1), ...); }, tab), calc(1, 0);
+        for (unsigned i = 2; i <= n; ++i) {
+            if (spf[i] == 0) spf[i] = i, ps.push_back(i);
+            if constexpr (mul) {
+                if (spf[i] == i) lpk[i] = i;
+                int k = 0;
+                if (lpk[i] == i) for (unsigned t = i; t > 1; t /= spf[i]) ++k;
+                calc(i, k);
             }
-            for (auto p: ps) {
-                i64 v = 1LL * i * p;
-                if (v > n) break;
-                mark[v] = p;
-                if (i % p == 0) {
-                    d[v] = d[i] + 1;
-                    facnum[v] = facnum[i] / (d[i] + 1) * (d[v] + 1);
-                    phi[v] = phi[i] * p;
-                    mu[v] = 0;
-                    break;
-                }
-                d[v] = 1;
-                facnum[v] = facnum[i] * 2;
-                phi[v] = phi[i] * (p - 1);
-                mu[v] = -mu[i];
+            for (unsigned p: ps) {
+                if (p > spf[i] || (u64) i * p > n) break;
+                spf[i * p] = p;
+                if constexpr (mul) lpk[i * p] = p == spf[i] ? lpk[i] * p : p;
             }
         }
+    } /// end-hash
+
+    template<class F>
+    const auto &get() const {
+        static_assert((is_same_v<F, Fs> || ...));
+        constexpr size_t I = [] { size_t i = 0, r = 0; ((is_same_v<F, Fs> && (r = i), ++i), ...); return r; }();
+        return std::get<I>(tab);
     }
-};
\ No newline at end of file
+
+    template<class F>
+    vector<typename F::type> range(u64 L, u64 R) const { /// start-hash
+        vector<u64> rem(R - L + 1);
+        vector<typename F::type> v(R - L + 1, F::one);
+        iota(all(rem), L);
+        for (unsigned p: ps) {
+            if ((u64) p * p > R) break;
+            for (u64 m = (L + p - 1) / p * p; m <= R; m += p) {
+                u64 &r = rem[m - L];
+                int k = 0;
+                while (r % p == 0) r /= p, ++k;
+                v[m - L] = F::combine(v[m - L], F::pk(p, k));
+            }
+        }
+        rep(i, 0, sz(v) - 1) if (rem[i] > 1) v[i] = F::combine(v[i], F::pk(rem[i], 1));
+        return v;
+    } /// end-hash
+};
@@ -1,46 +1,47 @@
 /**
  * Author: Yuhao Yao.
  * Date: 22-10-25
- * Description: vector in $\mathbb{Z}_3$.
- * Time: O(d / w) for +, -, * and /.
- * Status: tested on https://codeforces.com/gym/102394/problem/G.
+ * Description: vector in $\mathbb{Z}_3$, bit-sliced into two planes: $x_i = a_0[i] + 2 a_1[i]$ (the pair $(1, 1)$ never occurs).
+ *  $+$ takes $7$ word operations (instead of $3$ bitsets and about $9$), $-x$ swaps the planes.
+ *  $rref3(A, m)$ brings the rows of $A$ to reduced row echelon form on columns $[0, m)$ and returns the pivot columns; it copies the planes into flat words, so a row operation is $7$ word operations per word from the pivot column on. $solve3$ puts $b$ into column $m$ (so $m < d$), $kernel3$ returns a basis of $\{x : A x = 0\}$.
+ * Time: O(d / w) for +, -, * and /; O(n m \cdot \frac{d}{w}) for $rref3$, $rank3$, $solve3$, $kernel3$ of $n$ rows.
+ * Status: tested on https://codeforces.com/gym/102394/problem/G, elimination checked against brute force.
  */
 template<int d>
 struct v3 {
-	bitset<d> a[3]; /// start-hash
-
-	v3() { a[0].set(); }
+	bitset<d> a[2]; /// start-hash
 
 	void set(int pos, int x) {
-		rep(i, 0, 2) a[i][pos] = (i == x);
+		a[0][pos] = x == 1, a[1][pos] = x == 2;
 	}
 	int operator [](int i) const {
-		if (a[0][i]) return 0;
-		else if (a[1][i]) return 1;
-		else return 2;
+		return a[0][i] + a[1][i] * 2;
+	}
+	v3 &operator +=(const v3 &rhs) {
+		auto t = (a[0] | rhs.a[1]) ^ (a[1] | rhs.a[0]);
+		auto u = a[0] | rhs.a[0];
+		a[0] = (a[1] | rhs.a[1]) ^ t, a[1] = u ^ t;
+		return *this;
 	}
 	v3 operator +(const v3 &rhs) const {
+		v3 res = *this;
+		return res += rhs;
+	}
+	v3 operator -() const {
 		v3 res;
-		res.a[0] = (a[0] & rhs.a[0]) | (a[1] & rhs.a[2]) | (a[2] & rhs.a[1]);
-		res.a[1] = (a[0] & rhs.a[1]) | (a[1] & rhs.a[0]) | (a[2] & rhs.a[2]);
-		res.a[2] = (~res.a[0] & ~res.a[1]);
+		res.a[0] = a[1], res.a[1] = a[0];
 		return res;
 	}
 	v3 operator -(const v3 &rhs) const {
-		v3 tmp = rhs;
-		swap(tmp.a[1], tmp.a[2]);
-		return *this + tmp;
+		return *this + -rhs;
 	}
 	v3 operator *(int rhs) const {
-		if (rhs % 3 == 0) return v3{};
-		else {
-			auto res = *this;
-			if (rhs % 3 == 2) swap(res.a[1], res.a[2]);
-			return res;
-		}
+		rhs = (rhs % 3 + 3) % 3;
+		if (rhs == 0) return v3{};
+		return rhs == 1 ? *this : -*this;
 	}
 	v3 operator /(int rhs) const {
-		assert(rhs % 3 != 0); 
+		assert(rhs % 3 != 0);
 		return *this * rhs;
 	} /// end-hash
 
@@ -50,3 +51,65 @@ struct v3 {
 		return s;
 	}
 };
+
+// The elimination runs on plain words and only touches the words from the current column on.
+template<int d>
+vi rref3(vector<v3<d>> &A, int m) { /// start-hash
+	const int W = (d + 63) / 64;
+	int n = sz(A);
+	vector<u64> L(n * W), H(n * W);
+	rep(i, 0, n - 1) rep(j, 0, d - 1) {
+		int x = A[i][j];
+		L[i * W + j / 64] |= u64(x == 1) << (j % 64), H[i * W + j / 64] |= u64(x == 2) << (j % 64);
+	}
+	auto at = [&](int i, int c) { return int(L[i * W + c / 64] >> (c % 64) & 1) + int(H[i * W + c / 64] >> (c % 64) & 1) * 2; };
+	vi piv;
+	rep(c, 0, m - 1) {
+		int r = sz(piv), p = r;
+		while (p < n && !at(p, c)) ++p;
+		if (p == n) continue;
+		swap_ranges(&L[p * W], &L[p * W] + W, &L[r * W]), swap_ranges(&H[p * W], &H[p * W] + W, &H[r * W]);
+		if (at(r, c) == 2) swap_ranges(&L[r * W], &L[r * W] + W, &H[r * W]);
+		rep(i, 0, n - 1) if (i != r) {
+			int x = at(i, c);
+			if (!x) continue;
+			// row i += row r (x = 2) or -= row r (x = 1, the planes of row r swap).
+			u64 *l = &L[i * W], *h = &H[i * W], *pl = &(x == 2 ? L : H)[r * W], *ph = &(x == 2 ? H : L)[r * W];
+			rep(w, c / 64, W - 1) {
+				u64 t = (l[w] | ph[w]) ^ (h[w] | pl[w]), u = l[w] | pl[w];
+				l[w] = (h[w] | ph[w]) ^ t, h[w] = u ^ t;
+			}
+		}
+		piv.push_back(c);
+	}
+	rep(i, 0, n - 1) rep(j, 0, d - 1) A[i].set(j, at(i, j));
+	return piv;
+} /// end-hash
+
+template<int d>
+int rank3(vector<v3<d>> A, int m) { return sz(rref3(A, m)); }
+
+// A x = b with A of n x m (m < d). Returns {false, {}} if there is no solution.
+template<int d>
+pair<bool, v3<d>> solve3(vector<v3<d>> A, int m, const vi &b) { /// start-hash
+	rep(i, 0, sz(A) - 1) A[i].set(m, (b[i] % 3 + 3) % 3);
+	vi piv = rref3(A, m);
+	v3<d> x;
+	rep(i, sz(piv), sz(A) - 1) if (A[i][m]) return {false, {}};
+	rep(i, 0, sz(piv) - 1) x.set(piv[i], A[i][m]);
+	return {true, x};
+} /// end-hash
+
+template<int d>
+vector<v3<d>> kernel3(vector<v3<d>> A, int m) { /// start-hash
+	vi piv = rref3(A, m), isPiv(m);
+	for (int c: piv) isPiv[c] = 1;
+	vector<v3<d>> res;
+	rep(f, 0, m - 1) if (!isPiv[f]) {
+		v3<d> x;
+		x.set(f, 1);
+		rep(i, 0, sz(piv) - 1) x.set(piv[i], (3 - A[i][f]) % 3);
+		res.push_back(x);
+	}
+	return res;
+} /// end-hash
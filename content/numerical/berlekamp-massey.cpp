@@ -8,8 +8,8 @@
 template<int mod>
 class BerlekampMassey {
 private:
-	static ll mPow(ll a, ll k) {
-		ll res = 1;
+	static i64 mPow(i64 a, i64 k) {
+		i64 res = 1;
 		for (; k; k >>= 1, a = a * a % mod) if (k & 1) res = res * a % mod;
 		return res;
 	}
@@ -54,7 +54,7 @@ public:
 	}
 	// Returns seq[k], assuming \sum_{j = 0}^{t} rec[j] seq[i - j] = 0 (mod P) holds for i >= n
 	// Time complexity: O(t^2 log k)
-	int kthTerm(ll k) {
+	int kthTerm(i64 k) {
 		if (t == 1) return 1ll * seq[0] * mPow((mod - rec[1]) % mod, k) % mod;
 
 		vi cur(t * 2 + 2, 0), mult(t * 2 + 2, 0);
@@ -0,0 +1,81 @@
+/**
+ * Author: Boboge
+ * Date: 26-10-17
+ * Description: Convolution of many signals against one fixed kernel $ks$.
+ *  The transform of $ks$ is cached per length, so each $apply$ costs two transforms instead of three.
+ *  $applyBatch(xs, threads)$ transforms the kernel for every length needed and calls $prepare$ up front, then hands the signals out to $threads$ workers; the results are in input order.
+ *  $NTT$ can be $FFTAVX2$.
+ * Usage:
+ *  ConvPlan<Z> plan(ks);
+ *  vector<Z> cs = plan.apply(as);
+ *  vector<vector<Z>> css = plan.applyBatch(xss);
+ * Time: O(N \log N) per signal.
+ * Status: checked against FFT::conv on random inputs.
+ */
+#include "ntt.cpp"
+
+template<class mint = Z, class NTT = FFT<mint>>
+struct ConvPlan {
+    vector<mint> ks;
+    vector<vector<mint>> kdft; // kdft[b]: dft of ks padded to length 2^b.
+
+    ConvPlan(const vector<mint> &ks) : ks(ks) { assert(!ks.empty()); }
+
+    int length(int n) const { return 1 << __lg((n + sz(ks) - 1) * 2 - 1); }
+    bool naive(int n) const { return min(n, sz(ks)) <= 32; }
+
+    const vector<mint> &kernel(int n2) {
+        int b = __lg(n2);
+        if (sz(kdft) <= b) kdft.resize(b + 1);
+        if (kdft[b].empty()) {
+            kdft[b] = ks;
+            kdft[b].resize(n2, 0);
+            NTT::dft(kdft[b], 0);
+        }
+        return kdft[b];
+    }
+
+    // The kernel transform for sz(as) must be cached unless naive(sz(as)).
+    vector<mint> run(const vector<mint> &as) const { /// start-hash
+        int n = sz(as) + sz(ks) - 1;
+        if (naive(sz(as))) {
+            vector<mint> cs(n);
+            for (int i = 0; i < sz(as); ++i)
+                for (int j = 0; j < sz(ks); ++j) cs[i + j] += as[i] * ks[j];
+            return cs;
+        }
+        auto &kd = kdft[__lg(length(sz(as)))];
+        auto xs = as;
+        xs.resize(sz(kd), 0);
+        NTT::dft(xs, 0);
+        for (int i = 0; i < sz(xs); ++i) xs[i] *= kd[i];
+        NTT::dft(xs, 1);
+        xs.resize(n);
+        return xs;
+    } /// end-hash
+
+    vector<mint> apply(const vector<mint> &as) {
+        if (as.empty()) return {};
+        if (!naive(sz(as))) kernel(length(sz(as)));
+        return run(as);
+    }
+
+    vector<vector<mint>> applyBatch(const vector<vector<mint>> &xs, int threads = thread::hardware_concurrency()) { /// start-hash
+        int n = sz(xs), mx = 1;
+        for (auto &as: xs)
+            if (!naive(sz(as))) mx = max(mx, sz(kernel(length(sz(as)))));
+        NTT::prepare(mx);
+        vector<vector<mint>> res(n);
+        atomic<int> next{0};
+        auto work = [&]() {
+            for (int i; (i = next++) < n;)
+                if (!xs[i].empty()) res[i] = run(xs[i]);
+        };
+        threads = max(1, min(threads, n));
+        vector<thread> ts;
+        for (int t = 1; t < threads; ++t) ts.emplace_back(work);
+        work();
+        for (auto &t: ts) t.join();
+        return res;
+    } /// end-hash
+};
@@ -3,52 +3,93 @@
  * Date: 23-02-11
  * Description: Fast Walsh-Hadamard Transform of array $a$.
  * One can use it to do or/and/xor-convolution. Length of $a$ should be a power of $2$.
+ * The first levels are done block by block (each block of $2^{12}$ stays in cache), the rest two levels per pass, the butterflies have no branches, and $modnum$ is handled on its raw $int$ with a conditional subtraction, so all kernels vectorize (compile with AVX2 for $int$, $u64$ and $modnum$).
+ * The inverse xor transform ends with one multiplication by $1 / n$ ($modnum$, floating point) or a shift (integers, the result has to be exact).
  * Time: O(N \log N), where $N$ is the length of $a$.
  * Status: tested on https://www.luogu.com.cn/problem/P4717.
  */
+#pragma once
+
+template<class T>
+constexpr auto fwtMod(int) -> decltype(T::getMod(), 0) { return T::getMod(); }
+template<class T>
+constexpr int fwtMod(...) { return 0; }
+
+// f(j, j + s) for every level s and every j with j & s = 0.
+template<class F>
+void fwtRun(int n, F f) { /// start-hash
+    int B = min(n, 1 << 12);
+    for (int b = 0; b < n; b += B)
+        for (int s = 1; s < B; s <<= 1)
+            for (int i = b; i < b + B; i += s * 2)
+                for (int j = i; j < i + s; ++j) f(j, j + s);
+    int s = B;
+    for (; s * 2 < n; s <<= 2) // two levels per pass over the array.
+        for (int i = 0; i < n; i += s * 4)
+            for (int j = i; j < i + s; ++j) {
+                f(j, j + s), f(j + s * 2, j + s * 3);
+                f(j, j + s * 2), f(j + s, j + s * 3);
+            }
+    if (s < n)
+        for (int j = 0; j < s; ++j) f(j, j + s);
+} /// end-hash
 
 //fwt_or[i] = \sum a[j], j & i = j(j is the subset of i).
 template<class T>
 void fwt_or(vector<T> &a, int is_inv = 0) {
-    int n = sz(a);
-    for (int s = 1; s < n; s <<= 1) {
-        for (int i = 0; i < n; i += s << 1) {
-            for (int j = 0; j < s; j++) {
-                if (is_inv) a[i + j + s] -= a[i + j];
-                else a[i + j + s] += a[i + j];
-            }
-        }
+    constexpr int P = fwtMod<T>(0);
+    if constexpr (P > 0) {
+        static_assert(sizeof(T) == sizeof(int));
+        int *p = (int *) a.data();
+        if (is_inv) fwtRun(sz(a), [p](int i, int j) { p[j] -= p[i], p[j] += p[j] >> 31 & P; });
+        else fwtRun(sz(a), [p](int i, int j) { p[j] += p[i] - P, p[j] += p[j] >> 31 & P; });
+    } else {
+        T *p = a.data();
+        if (is_inv) fwtRun(sz(a), [p](int i, int j) { p[j] -= p[i]; });
+        else fwtRun(sz(a), [p](int i, int j) { p[j] += p[i]; });
     }
 }
 
 //fwt_and[i] = \sum a[j], j & i = i(j is the superset of i)
 template<class T>
 void fwt_and(vector<T> &a, int is_inv = 0) {
-    int n = sz(a);
-    for (int s = 1; s < n; s <<= 1) {
-        for (int i = 0; i < n; i += s << 1) {
-            for (int j = 0; j < s; j++) {
-                if (is_inv) a[i + j] -= a[i + j + s];
-                else a[i + j] += a[i + j + s];
-            }
-        }
+    constexpr int P = fwtMod<T>(0);
+    if constexpr (P > 0) {
+        static_assert(sizeof(T) == sizeof(int));
+        int *p = (int *) a.data();
+        if (is_inv) fwtRun(sz(a), [p](int i, int j) { p[i] -= p[j], p[i] += p[i] >> 31 & P; });
+        else fwtRun(sz(a), [p](int i, int j) { p[i] += p[j] - P, p[i] += p[i] >> 31 & P; });
+    } else {
+        T *p = a.data();
+        if (is_inv) fwtRun(sz(a), [p](int i, int j) { p[i] -= p[j]; });
+        else fwtRun(sz(a), [p](int i, int j) { p[i] += p[j]; });
     }
 }
 
-//don't know how it works
 template<class T>
 void fwt_xor(vector<T> &a, int is_inv = 0) {
+    constexpr int P = fwtMod<T>(0);
     int n = sz(a);
-    for (int s = 1; s < n; s <<= 1) {
-        for (int i = 0; i < n; i += s << 1) {
-            for (int j = 0; j < s; ++j) {
-                T x = a[i + j], y = a[i + j + s];
-                a[i + j] = x + y;
-                a[i + j + s] = x - y;
-            }
-        }
+    if constexpr (P > 0) {
+        static_assert(sizeof(T) == sizeof(int));
+        int *p = (int *) a.data();
+        fwtRun(n, [p](int i, int j) {
+            int u = p[i] + p[j] - P, v = p[i] - p[j];
+            p[i] = u + (u >> 31 & P), p[j] = v + (v >> 31 & P);
+        });
+    } else {
+        T *p = a.data();
+        fwtRun(n, [p](int i, int j) {
+            T u = p[i] + p[j], v = p[i] - p[j];
+            p[i] = u, p[j] = v;
+        });
     }
     if (is_inv) {
-        for (auto &x: a) x = x / n;
+        if constexpr (is_integral_v<T>) {
+            for (auto &x: a) x >>= __lg(n);
+        } else {
+            T inv = T(1) / T(n);
+            for (auto &x: a) x *= inv;
+        }
     }
-}
\ No newline at end of file
+}
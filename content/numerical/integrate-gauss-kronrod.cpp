@@ -0,0 +1,64 @@
+/**
+ * Author: Boboge
+ * Date: 26-10-17
+ * Description: Adaptive Gauss-Kronrod (G7-K15) integration of $f$ over $[a, b]$ to absolute error about $eps$. The 7 Gauss nodes are among the 15 Kronrod nodes, so one interval costs 15 evaluations and $|K_{15} - G_7|$ is its error estimate.
+ *  Instead of recursing, the intervals sit in a heap by error; each round splits the $batch$ worst ones and evaluates all $30 \cdot batch$ new points in one call of $f(x, y, n)$ ($y_i = f(x_i)$ for $i < n$), cut into $threads$ pieces run in parallel ($f$ must be thread safe then).
+ *  Stops when the summed error is at most $eps$ or there are $maxSeg$ intervals.
+ * Usage:
+ *  auto f = [](const double *x, double *y, int n) { rep(i, 0, n - 1) y[i] = sin(x[i]); };
+ *  double v = IntegrateGK(f, 0., 1.);
+ * Time: O(15 \cdot maxSeg) evaluations of $f$, typically far fewer than adaptive Simpson.
+ * Status: checked on smooth, peaked and endpoint-singular integrands.
+ */
+template<class T = double, class F>
+T IntegrateGK(F f, T a, T b, T eps = 1e-10, int batch = 1, int threads = 1, int maxSeg = 1 << 16) { /// start-hash
+	static const T xk[7] = {.991455371120812639206854697526329, .949107912342758524526189684047851, .864864423359769072789712788640926, .741531185599394439863864773280788, .586087235467691130294144845693013, .405845151377397166906606412076961, .207784955007898467600689403773245};
+	static const T wk[8] = {.022935322010529224963732008058970, .063092092629978553290700663189204, .104790010322250183839876322541518, .140653259715525918745189590510238, .169004726639267902826583426598550, .190350578064785409913256402421014, .204432940075298892414161999234649, .209482141084727828012999174891714};
+	static const T wg[4] = {.129484966168869693270611432679082, .279705391489276667901467771423780, .381830050505118944950369775488975, .417959183673469387755102040816327};
+	struct Seg {
+		T a, b, v, e;
+		bool operator<(const Seg &o) const { return e < o.e; }
+	};
+	priority_queue<Seg> pq;
+	vector<T> xs, ys;
+	T val = 0, err = 0;
+	auto add = [&](const vector<pair<T, T>> &iv) {
+		int n = sz(iv) * 15;
+		xs.resize(n), ys.resize(n);
+		rep(i, 0, sz(iv) - 1) {
+			T c = (iv[i].first + iv[i].second) / 2, h = (iv[i].second - iv[i].first) / 2, *x = &xs[i * 15];
+			x[7] = c;
+			rep(j, 0, 6) x[j] = c - h * xk[j], x[14 - j] = c + h * xk[j];
+		}
+		int th = min(threads, sz(iv));
+		if (th <= 1) f(xs.data(), ys.data(), n);
+		else {
+			vector<thread> ts;
+			rep(t, 0, th - 1) {
+				int l = sz(iv) * t / th * 15, r = sz(iv) * (t + 1) / th * 15;
+				ts.emplace_back([&, l, r] { f(xs.data() + l, ys.data() + l, r - l); });
+			}
+			for (auto &t: ts) t.join();
+		}
+		rep(i, 0, sz(iv) - 1) {
+			T h = (iv[i].second - iv[i].first) / 2, *y = &ys[i * 15], K = wk[7] * y[7], G = wg[3] * y[7];
+			rep(j, 0, 6) K += wk[j] * (y[j] + y[14 - j]);
+			rep(j, 0, 2) G += wg[j] * (y[j * 2 + 1] + y[13 - j * 2]);
+			Seg s{iv[i].first, iv[i].second, K * h, abs(K - G) * h};
+			pq.push(s), val += s.v, err += s.e;
+		}
+	};
+	add({{a, b}});
+	while (err > eps && sz(pq) < maxSeg) {
+		vector<pair<T, T>> iv;
+		rep(i, 1, batch) if (!pq.empty()) {
+			Seg s = pq.top();
+			pq.pop(), val -= s.v, err -= s.e;
+			T m = (s.a + s.b) / 2;
+			iv.push_back({s.a, m}), iv.push_back({m, s.b});
+		}
+		add(iv);
+	}
+	for (val = 0; !pq.empty(); pq.pop()) val += pq.top().v; // no drift from the running sum.
+	return val;
+} /// end-hash
@@ -0,0 +1,62 @@
+/**
+ * Author: Boboge
+ * Date: 26-10-17
+ * Description: Prefix Linear Base for range max-xor. Insert $x_0, x_1, \dots$ in order with their positions; for every pivot the base keeps the vector of the latest position (an older one is xored down instead), so after inserting $x_0 .. x_r$, $ask\_max(l)$ is the maximum xor of a subset of $x_l .. x_r$.
+ *  $T$ is $u64$ or $unsigned\ \_\_int128$ ($d \le 64$ / $128$). $has$ marks the pivots, so both operations only visit pivot bits.
+ *  $rangeMaxXor$ answers the queries offline in one sweep; for online queries keep a copy of $(a, p)$ after every insert, $O(n d)$ memory.
+ * Usage:
+ *  auto res = rangeMaxXor<60>(xs, {{l, r}, ...});
+ * Time: O(d) for $insert$ and $ask\_max$.
+ * Status: tested on https://codeforces.com/contest/1100/problem/F.
+ */
+#include "linear-base.cpp"
+
+template<int d, class T = u64>
+struct PrefixLB {
+    T a[d]{}, has = 0; /// start-hash
+    int p[d]{};
+
+    static int high(const T &x) { return LB<d, T>::high(x); }
+
+    void insert(T x, int pos) {
+        while (x) {
+            int i = high(x);
+            if (!(has >> i & 1)) {
+                a[i] = x, p[i] = pos, has |= T(1) << i;
+                return;
+            }
+            T y = a[i];
+            int q = p[i], sw = q < pos; // x ^ a[i] is the same whether or not they swap.
+            a[i] = sw ? x : y, p[i] = sw ? pos : q, pos = sw ? q : pos;
+            x ^= y;
+        }
+    }
+
+    // max of x ^ (xor of a subset of the inserted vectors at positions >= l).
+    T ask_max(int l, T x = 0) {
+        for (T m = has; m;) {
+            int i = high(m);
+            m ^= T(1) << i;
+            if (p[i] >= l && !(x >> i & 1)) x ^= a[i];
+        }
+        return x;
+    } /// end-hash
+};
+
+// res[j] = max xor of a subset of xs[l_j .. r_j], qs[j] = (l_j, r_j).
+template<int d, class T = u64>
+vector<T> rangeMaxXor(const vector<T> &xs, const vector<pii> &qs) { /// start-hash
+    int n = sz(xs), q = sz(qs);
+    vi st(n + 1), ord(q);
+    for (auto &[l, r]: qs) st[r + 1]++;
+    for (int i = 0; i < n; ++i) st[i + 1] += st[i];
+    vi pos(st.begin(), st.end() - 1);
+    for (int j = 0; j < q; ++j) ord[pos[qs[j].second]++] = j;
+    PrefixLB<d, T> lb;
+    vector<T> res(q);
+    for (int r = 0; r < n; ++r) {
+        lb.insert(xs[r], r);
+        for (int k = st[r]; k < st[r + 1]; ++k) res[ord[k]] = lb.ask_max(qs[ord[k]].first);
+    }
+    return res;
+} /// end-hash
@@ -4,9 +4,11 @@
  * Description: Maximum weighted of Linear Base of vector space $\mathbb{Z}_2^{d}$.
  *  $T$ is the type of vectors and $Z$ is the type of weights.
  *  $w[i]$ is the non-negative weight of a[i]. Keep $w[]$ zero to use unweighted Linear Base.
+ *  $T$ can also be $u64$ or $unsigned\ \_\_int128$ ($d \le 64$ / $128$): then $insert$ and $ask\_min$ jump straight to the highest set bit with $\_\_builtin\_clzll$ instead of testing every bit.
  * Time: O(d \cdot \frac{d}{w}) for $insert$; O(d^2 \cdot \frac{d}{w}) for union; O(d \cdot \frac{d}{w}) for $kth()$.
  * Status: tested on https://codeforces.com/contest/1100/problem/F, https://ac.nowcoder.com/acm/contest/11194/E, https://codeforces.com/gym/102156/problem/D, https://ac.nowcoder.com/acm/contest/884/B.
  */
+#pragma once
 template<int d, class T = bitset<d>, class Z = int>
 struct LB {
     vector<T> a; /// start-hash
@@ -16,32 +18,60 @@ struct LB {
 
     LB() : a(d), w(d) {}
 
+    static int bit(const T &x, int i) {
+        if constexpr (is_same_v<T, unsigned __int128> || is_integral_v<T>) return x >> i & 1;
+        else return x[i];
+    }
+
+    // The highest set bit of x not above i, -1 if there is none.
+    static int high(const T &x, int i = d - 1) {
+        if constexpr (is_same_v<T, unsigned __int128> || is_integral_v<T>) {
+            if (i < 0) return -1;
+            T y = i + 1 < int(sizeof(T) * 8) ? x & ((T(1) << (i + 1)) - 1) : x;
+            if constexpr (sizeof(T) == 16) {
+                u64 h = y >> 64;
+                return h ? 127 - __builtin_clzll(h) : (u64) y ? 63 - __builtin_clzll((u64) y) : -1;
+            } else {
+                return y ? 63 - __builtin_clzll(y) : -1;
+            }
+        } else {
+            while (i >= 0 && !x[i]) --i;
+            return i;
+        }
+    }
+
     // insert x. return 1 if the base is expanded.
     int insert(T x, Z val = 0) {
-        for (int i = d - 1; i >= 0; --i) {
-            if (x[i]) {
-                if (a[i] == 0) {
-                    a[i] = x;
-                    w[i] = val;
-                    return 1;
-                } else if (val > w[i]) {
-                    swap(a[i], x);
-                    swap(w[i], val);
-                }
-                x ^= a[i];
+        for (int i = high(x); i >= 0; i = high(x, i - 1)) {
+            if (a[i] == 0) {
+                a[i] = x;
+                w[i] = val;
+                return 1;
+            } else if (val > w[i]) {
+                swap(a[i], x);
+                swap(w[i], val);
             }
+            x ^= a[i];
         }
         return 0;
     } /// end-hash
 
     // View vectors as binary numbers. Then calculate the minimum number we can get if we add vectors from linear base (with weight at least $val$) to $x$.
     T ask_min(T x, Z val = 0) { /// start-hash
-        for (int i = d - 1; i >= 0; --i) {
-            if (x[i] && w[i] >= val) x ^= a[i]; // change x[i] to x[i] == 0 to ask maximum value we can get.
+        for (int i = high(x); i >= 0; i = high(x, i - 1)) {
+            if (w[i] >= val) x ^= a[i];
         }
         return x;
     } /// end-hash
 
+    // The maximum number we can get in the same way.
+    T ask_max(T x, Z val = 0) {
+        for (int i = d - 1; i >= 0; --i) {
+            if (!bit(x, i) && a[i] != 0 && w[i] >= val) x ^= a[i];
+        }
+        return x;
+    }
+
     // Compute the union of two bases.
     friend LB operator+(LB l, const LB &r) { /// start-hash
         for (int i = d - 1; i >=0; --i) {
@@ -61,8 +91,8 @@ struct LB {
         for (int i = d - 1; i >= 0; --i) {
             if (a[i] != 0 && w[i] >= val) {
                 --N;
-                auto bit = k >> N & 1;
-                if (res[i] != bit) res ^= a[i];
+                int b = k >> N & 1;
+                if (bit(res, i) != b) res ^= a[i];
             }
         }
         return res;
@@ -2,33 +2,97 @@
  * Author: Yuhao Yao
  * Date: 22-10-24
  * Description: Suppose $a_i = \sum_{j = 1} ^ {d} c_j * a_{i - j}$, then just let $A = \{a_0, ..., a_{d - 1}\}$ and $C = \{c_1, ..., c_d\}$.\\
- *  Here is how it works. Let $Q(x)$ be the characteristic polynomial of our recurrence, and $F(x) = \sum_{i = 0}^{\infty} a_i x^i$ be the generating formal power series of our sequence. Then it can be seen that all nonzero terms of $F(x) Q(x)$ are of at most $(n - 1)$-st power. This means that $F(x) = P(x) / Q(x)$ for some polynomial $P(x)$. Moreover, we know what $P(x)$ is: it is basically the first $n$ terms of $F(x) Q(x)$, that is, can be found in one multiplication of $a_0 + \ldots + a_{n - 1} x^{n - 1}$ and $Q(x)$, and then trimming to the proper degree.
- * Time: O(d \log^2 d).
+ *  Here is how it works. Let $Q(x)$ be the characteristic polynomial of our recurrence, and $F(x) = \sum_{i = 0}^{\infty} a_i x^i$ be the generating formal power series of our sequence. Then it can be seen that all nonzero terms of $F(x) Q(x)$ are of at most $(n - 1)$-st power. This means that $F(x) = P(x) / Q(x)$ for some polynomial $P(x)$. Moreover, we know what $P(x)$ is: it is basically the first $n$ terms of $F(x) Q(x)$, that is, can be found in one multiplication of $a_0 + \ldots + a_{n - 1} x^{n - 1}$ and $Q(x)$, and then trimming to the proper degree.\\
+ *  $[x^k] P / Q$ is found by Bostan--Mori: $P(x) Q(-x)$ and $Q(x) Q(-x)$ only keep the terms of parity $k$, and $k$ halves. Everything stays in the transform domain: $Q(-x)$ is read off by swapping the values at $\pm w$, taking the even / odd part halves the length, and the values at the other $N$ points are one length-$N$ $idft$ and $dft$ of $a_j \zeta_{2N}^j$ away.
+ *  $Q(x) Q(-x)$ does not depend on $k$, so $BostanMori$ keeps the chain of $Q$'s and answers many $k$ with about $2 \log k$ length-$N$ transforms each ($N = 2^{\lceil \log_2 \max(|P|, |Q|) \rceil}$, the chain takes $2 N \log k$ values).
+ * Usage:
+ *  BostanMori<Z> bm(P, Q); Z x = bm.get(k);
+ *  Z y = linear_rec_kth<Z>(A, C, k);
+ * Time: O(d \log d \log k) per query.
  * Status: tested on https://judge.yosupo.jp/problem/kth_term_of_linearly_recurrent_sequence.
  */
-
 #include "polynomial.cpp"
-template<class T>
-T fps_coeff(poly<T> P, poly<T> Q, ll k) {
-	while (k >= sz(Q)) {
-		auto nQ(Q);
-		rep(i, 0, sz(nQ) - 1) if (i & 1) nQ[i] = 0 - nQ[i];
-		auto PQ = P * nQ;
-		auto Q2 = Q * nQ;
-		poly<T> R, S;
-		rep(i, 0, sz(PQ) - 1) if ((k + i) % 2 == 0) R.push_back(PQ[i]);
-		rep(i, 0, sz(Q2) - 1) if (i % 2 == 0) S.push_back(Q2[i]);
-		
-		swap(P, R);
-		swap(Q, S);
-		k >>= 1;
+
+template<class T = Z, class FFT = FFT<T>>
+struct BostanMori {
+	using poly = Poly<T, FFT>;
+	int N;
+	poly P;
+	vector<T> ps;
+	vector<vector<T>> qs; // qs[l]: values of Q_l at the 2N points.
+	vector<poly> qinv; // qinv[l]: Q_l^{-1} mod x^N, filled on demand.
+
+	BostanMori(poly P_, const poly &Q) : P(P_) {
+		assert(!Q.empty() && Q[0] != 0);
+		N = 2;
+		while (N < max(sz(P), sz(Q))) N <<= 1;
+		FFT::prepare(N * 2);
+		ps = P, ps.resize(N * 2), FFT::dft(ps, 0);
+		qs.push_back(Q), qs[0].resize(N * 2), FFT::dft(qs[0], 0);
+	}
+
+	// hs: values of a polynomial of length <= N at the first N points -> values at all 2N points.
+	void extend(vector<T> &hs) { /// start-hash
+		hs.resize(N * 2);
+		copy(hs.begin(), hs.begin() + N, hs.begin() + N);
+		T *t = hs.data() + N, z = FFT::rt[N / 2], w = 1;
+		FFT::dft(t, N, 1);
+		rep(j, 0, N - 1) t[j] *= w, w *= z;
+		FFT::dft(t, N, 0);
+	} /// end-hash
+
+	const vector<T> &level(int l) {
+		while (sz(qs) <= l) {
+			auto &q = qs.back();
+			vector<T> hs(N);
+			rep(s, 0, N - 1) hs[s] = q[s * 2] * q[s * 2 + 1];
+			extend(hs);
+			qs.push_back(move(hs));
+		}
+		return qs[l];
 	}
-	return (P * Q.inv())[k];
+
+	T get(i64 k) { /// start-hash
+		const T inv2 = T{1} / 2;
+		vector<T> cur = ps, hs(N);
+		int l = 0;
+		for (; k >= N; k >>= 1, ++l) {
+			if (l) extend(cur = hs);
+			auto &q = level(l);
+			rep(s, 0, N - 1) {
+				T a = cur[s * 2] * q[s * 2 + 1], b = cur[s * 2 + 1] * q[s * 2];
+				hs[s] = (k & 1 ? (a - b) * FFT::irt[s] : a + b) * inv2;
+			}
+		}
+		poly cs;
+		if (l == 0) cs = P;
+		else cs = hs, FFT::dft(cs, 1);
+		if (sz(qinv) <= l) qinv.resize(l + 1);
+		if (qinv[l].empty()) {
+			poly q = level(l);
+			FFT::dft(q, 1);
+			qinv[l] = q.inv(N);
+		}
+		T res = 0;
+		rep(i, 0, min<i64>(k, sz(cs) - 1)) res += cs[i] * qinv[l][k - i];
+		return res;
+	} /// end-hash
+
+	vector<T> get(const vector<i64> &ks) {
+		vector<T> res;
+		for (auto k: ks) res.push_back(get(k));
+		return res;
+	}
+};
+
+template<class T = Z>
+T fps_coeff(const Poly<T> &P, const Poly<T> &Q, i64 k) {
+	return BostanMori<T>(P, Q).get(k);
 }
 
-template<class T>
-T linear_rec_kth(const poly<T> &A, const poly<T> &C, ll k) {
-	poly<T> Q{1}; // Q is characteristic polynomial.
+template<class T = Z>
+T linear_rec_kth(const Poly<T> &A, const Poly<T> &C, i64 k) {
+	Poly<T> Q{1}; // Q is characteristic polynomial.
 	for (auto x: C) Q.push_back(0 - x);
 	auto P = A * Q;
 	P.resize(sz(Q) - 1);
@@ -1,130 +1,254 @@
 /**
  * Author: Yuhao Yao
  * Date: 22-10-24
- * Description: Matrix struct. 
+ * Description: Matrix struct, stored row-major in one array ($A[i]$ is a pointer to row $i$).
+ *  $A * B$ is blocked over columns and goes four rows of $A$ at a time. For modular $T$ (with static $getMod()$, $mod < 2^{30}$) it accumulates products in $u64$ and reduces only every $\lfloor 2^{64} / (mod - 1)^2 \rfloor \ge 16$ terms.
+ *  $pow(k)$ gives $A^k$ for square $A$.
  *  $Gaussian(C)$ eliminates the first $C$ columns and returns the rank of matrix induced by first $C$ columns.
  *  $inverse()$ gives the inverse of the matrix.
  *  $SolveLinear(A, b)$ solves linear system $A x =  b$ for matrix $A$ and vector $b$.
- *  Besides, you need function $isZero$ for your template $T$.
+ *  Besides, you need function $isZero$ for your template $T$ unless it is modular.
+ *  Elimination runs row updates on $threads$ threads once a step is large enough. Floating point types pivot on the largest magnitude. Modular types pivot on any nonzero and apply up to $16$ pivots to all rows at once with one reduction per entry.
  * Usage: For SolveLinear():
  *  bool isZero(double x) { return abs(x) <= 1e-9; } // global
  *  Matrix<double> A(3, 4);
  *  vector<double> b(3);
  *  ... // set values for A and b.
  *  vector<double> xs = SolveLinear(A, b);
- * Time: O(n m \min\{n, m\}) for Gaussian, inverse and SolveLinear.
+ * Time: O(n m l) for multiplication, O(n^3 \log k) for pow, O(n m \min\{n, m\}) for Gaussian, inverse and SolveLinear.
  * Status: inverse() tested on https://ac.nowcoder.com/acm/contest/33187/J; 
  *  SolveLinear() tested on https://www.luogu.com.cn/problem/P6125.
  */
+template<class T, class = void>
+struct HasMod : false_type {};
+template<class T>
+struct HasMod<T, void_t<decltype(T::getMod())>> : true_type {};
+
 template<class T>
 struct Matrix {
     using Mat = Matrix; /// start-hash
     using Vec = vector<T>;
 
-    vector<Vec> a;
+    int n, m;
+    Vec a;
 
-    Matrix(int n, int m) {
+    Matrix(int n, int m) : n(n), m(m), a(n * m) {
         assert(n > 0 && m > 0);
-        a.assign(n, Vec(m));
     }
 
-    Matrix(const vector<Vec> &a) : a(a) {
-        assert(!a.empty() && !a[0].empty());
+    Matrix(const vector<Vec> &v) : Matrix(sz(v), v.empty() ? 0 : sz(v[0])) {
+        for (int i = 0; i < n; ++i) copy(all(v[i]), (*this)[i]);
     }
 
-    Vec &operator[](int i) const { return (Vec &) a[i]; }
+    T *operator[](int i) const { return (T *) a.data() + i * m; }
     /// end-hash
 
     Mat operator+(const Mat &b) const {
-        int n = sz(a), m = sz(a[0]);
         Mat c(n, m);
-        for (int i = 0; i < n; ++i) {
-            for (int j = 0; j < m; ++j) {
-                c[i][j] = a[i][j] + b[i][j];
-            }
-        }
+        for (int i = 0; i < n * m; ++i) c.a[i] = a[i] + b.a[i];
         return c;
     }
 
     Mat operator-(const Mat &b) const {
-        int n = sz(a), m = sz(a[0]);
         Mat c(n, m);
-        for (int i = 0; i < n; ++i) {
-            for (int j = 0; j < m; ++j) {
-                c[i][j] = a[i][j] - b[i][j];
-            }
-        }
+        for (int i = 0; i < n * m; ++i) c.a[i] = a[i] - b.a[i];
         return c;
     }
 
-    Mat operator*(const Mat &b) const {
-        int n = sz(a), m = sz(a[0]), l = sz(b[0]);
-        assert(m == sz(b));
+    Mat operator*(const Mat &b) const { /// start-hash
+        assert(m == b.n);
+        int l = b.m;
         Mat c(n, l);
-        for (int i = 0; i < n; ++i) {
-            for (int k = 0; k < m; ++k) {
-                for (int j = 0; j < l; ++j) {
-                    c[i][j] += a[i][k] * b[k][j];
+        if constexpr (HasMod<T>::value) {
+            constexpr u64 P = T::getMod(), K = min<u64>((~0ULL - P) / max<u64>((P - 1) * (P - 1), 1), 1 << 20);
+            const int BJ = 256;
+            vector<u64> xs(n * m), ys(m * l), acc(BJ * 4);
+            for (int i = 0; i < n * m; ++i) xs[i] = a[i].val();
+            for (int i = 0; i < m * l; ++i) ys[i] = b.a[i].val();
+            for (int j0 = 0; j0 < l; j0 += BJ) {
+                int w = min(BJ, l - j0);
+                for (int i0 = 0; i0 < n; i0 += 4) {
+                    u64 *c0 = acc.data(), *c1 = c0 + BJ, *c2 = c1 + BJ, *c3 = c2 + BJ;
+                    fill(all(acc), 0);
+                    for (int k = 0; k < m; ++k) {
+                        auto x = [&](int r) { return i0 + r < n ? xs[(i0 + r) * m + k] : 0; };
+                        u64 x0 = x(0), x1 = x(1), x2 = x(2), x3 = x(3);
+                        const u64 *y = ys.data() + k * l + j0;
+                        for (int j = 0; j < w; ++j) {
+                            c0[j] += x0 * y[j], c1[j] += x1 * y[j];
+                            c2[j] += x2 * y[j], c3[j] += x3 * y[j];
+                        }
+                        if ((k + 1) % K == 0)
+                            for (auto &v: acc) v %= P;
+                    }
+                    for (int r = 0; r < 4 && i0 + r < n; ++r)
+                        for (int j = 0; j < w; ++j) c[i0 + r][j0 + j] = i64(acc[r * BJ + j] % P);
                 }
             }
+        } else {
+            const int BK = 64;
+            for (int k0 = 0; k0 < m; k0 += BK)
+                for (int i = 0; i < n; ++i)
+                    for (int k = k0; k < min(m, k0 + BK); ++k) {
+                        T x = a[i * m + k], *cr = c[i], *br = b[k];
+                        for (int j = 0; j < l; ++j) cr[j] += x * br[j];
+                    }
         }
         return c;
-    }
+    } /// end-hash
+
+    Mat pow(i64 k) const { /// start-hash
+        assert(n == m && k >= 0);
+        Mat res(n, n), b = *this;
+        for (int i = 0; i < n; ++i) res[i][i] = 1;
+        for (; k; k >>= 1) {
+            if (k & 1) res = res * b;
+            if (k > 1) b = b * b;
+        }
+        return res;
+    } /// end-hash
 
     Mat tran() const {
-        int n = sz(a), m = sz(a[0]);
         Mat res(m, n);
         for (int i = 0; i < n; ++i)
             for (int j = 0; j < m; ++j)
-                res[j][i] = a[i][j];
+                res[j][i] = (*this)[i][j];
         return res;
     }
 
+    inline static int threads = max(1u, thread::hardware_concurrency());
+
+    // f(i) for every row i, split over threads when there is enough work.
+    template<class F>
+    static void forRows(int n, i64 work, F f) {
+        int t = work < (1 << 20) ? 1 : min(threads, n);
+        if (t == 1) {
+            for (int i = 0; i < n; ++i) f(i);
+            return;
+        }
+        vector<thread> ts;
+        for (int k = 0; k < t; ++k) ts.emplace_back([&, k] { for (int i = k; i < n; i += t) f(i); });
+        for (auto &th: ts) th.join();
+    }
+
+    static bool zero(const T &x) {
+        if constexpr (HasMod<T>::value) return x == T{};
+        else return isZero(x);
+    }
+
     // Eliminate the first C columns, return the rank of matrix induced by first C columns.
+    // Floating point: partial pivoting by magnitude. Modular: see gaussMod.
     int Gaussian(int C) { /// start-hash
-        int n = sz(a), m = sz(a[0]), rk = 0;
         assert(C <= m);
-        for (int c = 0; c < C; ++c) {
-            int id = rk;
-            while (id < n && ::isZero(a[id][c])) id++;
-            if (id == n) continue;
-            if (id != rk) swap(a[id], a[rk]);
-            T tmp = a[rk][c];
-            for (auto &x: a[rk]) x /= tmp;
-            for (int i = 0; i < n; ++i) {
-                if (i != rk) {
-                    T fac = a[i][c];
-                    for (int j = 0; j < m; ++j) {
-                        a[i][j] -= fac * a[rk][j];
-                    }
+        if constexpr (HasMod<T>::value) return gaussMod(C);
+        else {
+            int rk = 0;
+            for (int c = 0; c < C && rk < n; ++c) {
+                int id = rk;
+                if constexpr (is_floating_point_v<T>) {
+                    for (int i = rk + 1; i < n; ++i)
+                        if (abs((*this)[i][c]) > abs((*this)[id][c])) id = i;
+                    if (isZero((*this)[id][c])) continue;
+                } else {
+                    while (id < n && isZero((*this)[id][c])) id++;
+                    if (id == n) continue;
                 }
+                T *pr = (*this)[rk];
+                if (id != rk) swap_ranges(pr, pr + m, (*this)[id]);
+                T tmp = pr[c];
+                for (int j = c; j < m; ++j) pr[j] /= tmp;
+                forRows(n, i64(n) * (m - c), [&](int i) {
+                    if (i == rk) return;
+                    T *r = (*this)[i], fac = r[c];
+                    for (int j = c; j < m; ++j) r[j] -= fac * pr[j];
+                });
+                rk++;
             }
-            rk++;
+            return rk;
         }
+    } /// end-hash
+
+    // Gauss-Jordan with delayed updates: up to K pivot rows are kept aside together with every row's multipliers,
+    // and then applied to all rows at once, K products accumulated in u64 per reduction. Any nonzero entry is a pivot.
+    int gaussMod(int C) { /// start-hash
+        constexpr u64 P = T::getMod();
+        const int K = 16, BJ = 256;
+        vector<u64> f(n * K), ps(K * m);
+        vector<int> pc;
+        auto apply = [&](int i) {
+            const u64 *fi = f.data() + i * K;
+            T *r = (*this)[i];
+            u64 buf[BJ];
+            for (int j0 = pc[0]; j0 < m; j0 += BJ) {
+                int w = min(BJ, m - j0);
+                for (int j = 0; j < w; ++j) buf[j] = r[j0 + j].val();
+                for (int s = 0; s < sz(pc); ++s) {
+                    if (!fi[s]) continue;
+                    u64 x = P - fi[s];
+                    const u64 *p = ps.data() + s * m + j0;
+                    for (int j = 0; j < w; ++j) buf[j] += x * p[j];
+                }
+                for (int j = 0; j < w; ++j) r[j0 + j] = i64(buf[j] % P);
+            }
+            fill(f.begin() + i * K, f.begin() + i * K + K, 0);
+        };
+        auto flush = [&]() {
+            if (pc.empty()) return;
+            forRows(n, i64(n) * m * sz(pc), apply);
+            pc.clear();
+        };
+        int rk = 0;
+        vector<u64> cur(n);
+        for (int c = 0; c < C && rk < n; ++c) {
+            int t = sz(pc), id = -1;
+            for (int i = 0; i < n; ++i) {
+                u64 v = (*this)[i][c].val();
+                for (int s = 0; s < t; ++s) v += (P - f[i * K + s]) * ps[s * m + c];
+                cur[i] = v % P;
+                if (id == -1 && i >= rk && cur[i]) id = i;
+            }
+            if (id == -1) continue;
+            T *pr = (*this)[rk];
+            if (id != rk) {
+                swap_ranges(pr, pr + m, (*this)[id]);
+                swap_ranges(f.begin() + rk * K, f.begin() + rk * K + K, f.begin() + id * K);
+                swap(cur[rk], cur[id]);
+            }
+            if (t) apply(rk);
+            T inv = T{1} / pr[c];
+            for (int j = c; j < m; ++j) pr[j] *= inv, ps[t * m + j] = pr[j].val();
+            fill(ps.begin() + t * m, ps.begin() + t * m + c, 0);
+            for (int i = 0; i < n; ++i) f[i * K + t] = i == rk ? 0 : cur[i];
+            pc.push_back(c), rk++;
+            if (sz(pc) == K) flush();
+        }
+        flush();
         return rk;
     } /// end-hash
 
     Mat inverse() const { /// start-hash
-        int n = sz(a), m = sz(a[0]);
         assert(n == m);
-        auto b = *this;
+        Mat b(n, n * 2);
         for (int i = 0; i < n; ++i)
-            b[i].resize(n * 2, 0), b[i][n + i] = 1;
+            copy((*this)[i], (*this)[i] + n, b[i]), b[i][n + i] = 1;
         assert(b.Gaussian(n) == n);
-        for (auto &row: b.a) row.erase(row.begin(), row.begin() + n);
-        return b;
+        Mat res(n, n);
+        for (int i = 0; i < n; ++i) copy(b[i] + n, b[i] + n * 2, res[i]);
+        return res;
     } /// end-hash
 
     //return [true, solution] if there's any solution, if the solution is not unique, rk < n
-    friend pair<bool, Vec> SolveLinear(Mat A, const Vec &b) { /// start-hash
-        int n = sz(A.a), m = sz(A[0]);
+    friend pair<bool, Vec> SolveLinear(const Mat &A0, const Vec &b) { /// start-hash
+        int n = A0.n, m = A0.m;
         assert(sz(b) == n);
+        Mat A(n, m + 1);
         for (int i = 0; i < n; ++i) {
-            A[i].push_back(b[i]);
+            copy(A0[i], A0[i] + m, A[i]);
+            A[i][m] = b[i];
         }
         int rk = A.Gaussian(m);
         for (int i = rk; i < n; ++i) {
-            if (::isZero(A[i].back()) == 0) {
+            if (!zero(A[i][m])) {
                 return {0, Vec{}};
             }
         }
@@ -133,7 +257,7 @@ struct Matrix {
             T x = A[i][m];
             int last = -1;
             for (int j = m - 1; j >= 0; --j) {
-                if (::isZero(A[i][j]) == 0) {
+                if (!zero(A[i][j])) {
                     x -= A[i][j] * res[j];
                     last = j;
                 }
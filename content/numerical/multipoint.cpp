@@ -0,0 +1,147 @@
+/**
+ * Author: Boboge
+ * Date: 26-10-17
+ * Description: Subproduct tree over points $x_0, \dots, x_{n - 1}$ for multipoint evaluation and interpolation.
+ *  Node $v$ over $[l, r)$ stores $P_v = \prod_{l \le i < r} (x - x_i)$; all of them live in one array $pool$ (and the per-node values of a query in $buf$), so rebuilding for another batch reuses the memory.
+ *  $evaluate(f)$ is the transposed (Tellegen) algorithm: the root gets $u_j = \sum_k f_{k + j} [x^k] rev(P_{root})^{-1}$ by one middle product, and a child $c$ with sibling $c'$ gets $u_c = middle(u_v, P_{c'})$; a leaf ends with $f(x_i)$. No polynomial division is needed.
+ *  $interpolate(ys)$ returns the $f$ of degree $< n$ with $f(x_i) = ys_i$ ($x_i$ must be distinct).
+ * Usage:
+ *  SubproductTree<Z> tr(xs);
+ *  vector<Z> ys = tr.evaluate(f);
+ *  Poly<Z> g = tr.interpolate(ys);
+ * Time: O(N \log^2 N) for building, $evaluate$ and $interpolate$.
+ * Status: checked against brute force on random inputs.
+ */
+#include "polynomial.cpp"
+
+template<class T = Z, class FFT = FFT<T>>
+struct SubproductTree {
+    using poly = Poly<T, FFT>;
+    int n = 0;
+    vector<T> pool, buf, s1, s2, s3, s4; // s1 ... s4: scratch for the transforms.
+    vector<int> off;
+
+    SubproductTree(const vector<T> &xs) { build(xs); }
+
+    T *P(int v) { return pool.data() + off[v]; }
+    T *U(int v) { return buf.data() + off[v]; }
+
+    // s = dft of a[0, na) wrapped around to length n2.
+    void load(vector<T> &s, const T *a, int na, int n2) {
+        s.assign(n2, 0);
+        for (int i = 0; i < na; ++i) s[i & (n2 - 1)] += a[i];
+        FFT::dft(s.data(), n2, 0);
+    }
+
+    void build(const vector<T> &xs) { /// start-hash
+        n = sz(xs);
+        off.assign(max(n, 1) * 4, 0);
+        int tot = 0;
+        auto place = [&](auto &self, int v, int l, int r) -> void {
+            off[v] = tot, tot += r - l + 1;
+            if (r - l > 1) self(self, v * 2, l, (l + r) / 2), self(self, v * 2 + 1, (l + r) / 2, r);
+        };
+        if (n > 0) place(place, 1, 0, n);
+        pool.assign(tot, 0), buf.assign(tot, 0);
+        auto dfs = [&](auto &self, int v, int l, int r) -> void {
+            T *p = P(v);
+            if (r - l == 1) {
+                p[0] = -xs[l], p[1] = 1;
+                return;
+            }
+            int mid = (l + r) / 2, L = r - l;
+            self(self, v * 2, l, mid), self(self, v * 2 + 1, mid, r);
+            T *a = P(v * 2), *b = P(v * 2 + 1);
+            if (L <= 64) {
+                fill(p, p + L + 1, 0);
+                for (int i = 0; i <= mid - l; ++i)
+                    for (int j = 0; j <= r - mid; ++j) p[i + j] += a[i] * b[j];
+                return;
+            }
+            int n2 = 1 << __lg(L * 2 - 1); // the product is monic, so a length-L cyclic product suffices.
+            load(s1, a, mid - l + 1, n2), load(s2, b, r - mid + 1, n2);
+            for (int i = 0; i < n2; ++i) s1[i] *= s2[i];
+            FFT::dft(s1.data(), n2, 1);
+            copy(s1.begin(), s1.begin() + L, p);
+            if (n2 == L) p[0] -= 1;
+            p[L] = 1;
+        };
+        if (n > 0) dfs(dfs, 1, 0, n);
+    } /// end-hash
+
+    vector<T> evaluate(poly f) { /// start-hash
+        if (n == 0) return {};
+        if (f.empty()) return vector<T>(n, 0);
+        int m = sz(f);
+        poly t(P(1), P(1) + n + 1);
+        reverse(all(t));
+        t = t.inv(m);
+        reverse(all(t));
+        f.resize(m + n - 1);
+        auto u = FFT::middle(f, t);
+        copy(all(u), U(1));
+        vector<T> ys(n);
+        auto dfs = [&](auto &self, int v, int l, int r) -> void {
+            if (r - l == 1) {
+                ys[l] = U(v)[0];
+                return;
+            }
+            int mid = (l + r) / 2, L = r - l, nl = mid - l, nr = r - mid;
+            T *u = U(v), *a = P(v * 2), *b = P(v * 2 + 1);
+            if (L <= 64) {
+                for (int i = 0; i < nl; ++i) {
+                    T x = 0;
+                    for (int j = 0; j <= nr; ++j) x += u[i + j] * b[nr - j];
+                    U(v * 2)[i] = x;
+                }
+                for (int i = 0; i < nr; ++i) {
+                    T x = 0;
+                    for (int j = 0; j <= nl; ++j) x += u[i + j] * a[nl - j];
+                    U(v * 2 + 1)[i] = x;
+                }
+            } else {
+                int n2 = 1 << __lg(L * 2 - 1);
+                load(s1, u, L, n2), load(s2, b, nr + 1, n2), load(s3, a, nl + 1, n2);
+                for (int i = 0; i < n2; ++i) s2[i] *= s1[i], s3[i] *= s1[i];
+                FFT::dft(s2.data(), n2, 1), FFT::dft(s3.data(), n2, 1);
+                copy(s2.begin() + nr, s2.begin() + L, U(v * 2));
+                copy(s3.begin() + nl, s3.begin() + L, U(v * 2 + 1));
+            }
+            self(self, v * 2, l, mid), self(self, v * 2 + 1, mid, r);
+        };
+        dfs(dfs, 1, 0, n);
+        return ys;
+    } /// end-hash
+
+    poly interpolate(const vector<T> &ys) { /// start-hash
+        assert(sz(ys) == n);
+        if (n == 0) return {};
+        poly dp(P(1) + 1, P(1) + n + 1);
+        for (int i = 0; i < n; ++i) dp[i] *= i + 1;
+        auto ds = evaluate(dp);
+        auto dfs = [&](auto &self, int v, int l, int r) -> void {
+            if (r - l == 1) {
+                U(v)[0] = ys[l] / ds[l];
+                return;
+            }
+            int mid = (l + r) / 2, L = r - l, nl = mid - l, nr = r - mid;
+            self(self, v * 2, l, mid), self(self, v * 2 + 1, mid, r);
+            T *u = U(v), *a = P(v * 2), *b = P(v * 2 + 1), *ul = U(v * 2), *ur = U(v * 2 + 1);
+            if (L <= 64) {
+                fill(u, u + L, 0);
+                for (int i = 0; i < nl; ++i)
+                    for (int j = 0; j <= nr; ++j) u[i + j] += ul[i] * b[j];
+                for (int i = 0; i < nr; ++i)
+                    for (int j = 0; j <= nl; ++j) u[i + j] += ur[i] * a[j];
+                return;
+            }
+            int n2 = 1 << __lg(L * 2 - 1);
+            load(s1, ul, nl, n2), load(s2, b, nr + 1, n2), load(s3, ur, nr, n2), load(s4, a, nl + 1, n2);
+            for (int i = 0; i < n2; ++i) s1[i] = s1[i] * s2[i] + s3[i] * s4[i];
+            FFT::dft(s1.data(), n2, 1);
+            copy(s1.begin(), s1.begin() + L, u);
+        };
+        dfs(dfs, 1, 0, n);
+        return poly(U(1), U(1) + n);
+    } /// end-hash
+};
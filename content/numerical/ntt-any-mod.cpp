@@ -0,0 +1,54 @@
+/**
+ * Author: Boboge
+ * Date: 26-10-17
+ * Description: Exact convolution modulo an arbitrary $mod \le 2^{30} - 1$ (e.g. $10^9 + 7$): three NTTs modulo 754974721, 167772161 and 469762049 and Garner's CRT.
+ *  Works as long as $\min(|A|, |B|) \cdot mod^2 < 5.9 \cdot 10^{25}$ and $|A| + |B| \le 2^{24} + 1$, i.e. up to length $2^{23}$ inputs at $10^9 + 7$.
+ *  Same interface as $FFT<T>$, so it can be plugged into $Poly$ (only the operations built on $conv$, not $inv$ / $exp$, which need a $dft$).
+ *  $NTT$ can be $FFTAVX2$.
+ * Usage:
+ *  using Z7 = mint<1000000007>;
+ *  vector<Z7> cs = FFTAnyMod<Z7>::conv(as, bs);
+ *  Poly<Z7, FFTAnyMod<Z7>> f;
+ * Time: O(N \log N), about 3 times an NTT convolution.
+ * Status: checked against brute force on random inputs.
+ */
+#include "ntt.cpp"
+
+template<class T = Z, template<class> class NTT = FFT>
+struct FFTAnyMod {
+    using M0 = mint<754974721>;
+    using M1 = mint<167772161>;
+    using M2 = mint<469762049>;
+
+    template<class M>
+    static vector<M> convMod(const vector<T> &as, const vector<T> &bs) {
+        vector<M> xs(sz(as)), ys(sz(bs));
+        for (int i = 0; i < sz(as); ++i) xs[i] = as[i].val();
+        for (int i = 0; i < sz(bs); ++i) ys[i] = bs[i].val();
+        return NTT<M>::conv(xs, ys);
+    }
+
+    static vector<T> conv(const vector<T> &as, const vector<T> &bs) { /// start-hash
+        if (min(sz(as), sz(bs)) <= 64) {
+            vector<T> cs(sz(as) + sz(bs) - 1);
+            for (int i = 0; i < sz(as); ++i)
+                for (int j = 0; j < sz(bs); ++j)
+                    cs[i + j] += as[i] * bs[j];
+            return cs;
+        }
+        auto c0 = convMod<M0>(as, bs);
+        auto c1 = convMod<M1>(as, bs);
+        auto c2 = convMod<M2>(as, bs);
+        const M1 r01 = M1{1} / M0::getMod();
+        const M2 r02 = M2{1} / M0::getMod(), r12 = M2{1} / M1::getMod();
+        const T m0 = M0::getMod(), m01 = m0 * M1::getMod();
+        vector<T> cs(sz(c0));
+        for (int i = 0; i < sz(cs); ++i) {
+            int x0 = c0[i].val();
+            int x1 = ((c1[i] - x0) * r01).val();
+            int x2 = (((c2[i] - x0) * r02 - x1) * r12).val();
+            cs[i] = m01 * x2 + m0 * x1 + x0;
+        }
+        return cs;
+    } /// end-hash
+};
@@ -0,0 +1,145 @@
+/**
+ * Author: Boboge
+ * Date: 26-10-17
+ * Description: AVX2 version of $FFT<mint>$ (same interface, bit-for-bit the same results) for $mod < 2^{30}$.
+ *  Butterflies run on 8 lanes with 32-bit Montgomery reduction: the data stays in normal form and only the twiddles are stored as $w \cdot 2^{32}$, so one reduction gives $a \cdot w$ directly.
+ *  Stages with fewer than 8 butterflies per block fall back to scalar code.
+ *  Compile with -mavx2 (or \#pragma GCC target("avx2") before including bits/stdc++.h); otherwise $FFTAVX2$ is just $FFT$.
+ * Usage:
+ *  vector<Z> cs = FFTAVX2<Z>::conv(as, bs);
+ *  Poly<Z, FFTAVX2<Z>> f; // Poly picks it up through its second template parameter.
+ * Time: O(N \log N).
+ * Status: checked against FFT<Z>::conv on random inputs.
+ */
+#include "ntt.cpp"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+
+template<class mint = Z>
+struct FFTAVX2 : FFT<mint> {
+    using B = FFT<mint>;
+    using u32 = unsigned;
+    static constexpr u32 P = mint::getMod();
+    static constexpr u32 Pinv = [] { u32 x = P; for (int i = 0; i < 4; ++i) x *= 2 - P * x; return x; }(); // P * Pinv = 1 mod 2^32.
+    inline static vector<u32> mrt, mirt; // rt and irt in Montgomery form.
+
+    static u32 mont(mint x) { return (u64) x.val() * (1ull << 32) % P; }
+
+    static void prepare(int n) {
+        B::prepare(n);
+        for (int s = sz(mrt); s < sz(B::rt); ++s) {
+            mrt.push_back(mont(B::rt[s]));
+            mirt.push_back(mont(B::irt[s]));
+        }
+    }
+
+    static __m256i add(__m256i a, __m256i b) { /// start-hash
+        a = _mm256_add_epi32(a, b);
+        return _mm256_min_epu32(a, _mm256_sub_epi32(a, _mm256_set1_epi32(P)));
+    }
+    static __m256i sub(__m256i a, __m256i b) {
+        a = _mm256_sub_epi32(a, b);
+        return _mm256_min_epu32(a, _mm256_add_epi32(a, _mm256_set1_epi32(P)));
+    }
+    static __m256i mul(__m256i a, __m256i b) { // a * b / 2^32 mod P.
+        const __m256i vp = _mm256_set1_epi32(P), vpinv = _mm256_set1_epi32(Pinv);
+        __m256i te = _mm256_mul_epu32(a, b);
+        __m256i to = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+        __m256i qe = _mm256_mul_epu32(_mm256_mul_epu32(te, vpinv), vp);
+        __m256i qo = _mm256_mul_epu32(_mm256_mul_epu32(to, vpinv), vp);
+        __m256i r = _mm256_blend_epi32(_mm256_srli_epi64(_mm256_sub_epi64(te, qe), 32), _mm256_sub_epi64(to, qo), 0b10101010);
+        return _mm256_min_epu32(r, _mm256_add_epi32(r, vp));
+    } /// end-hash
+
+    // dft without the final division by n.
+    static void run(mint *as, int n, int is_inv) { /// start-hash
+        prepare(n);
+        const mint im = B::rt[1], iim = B::irt[1];
+        const __m256i vim = _mm256_set1_epi32(mrt[1]), viim = _mm256_set1_epi32(mirt[1]);
+        auto ld = [&](int i) { return _mm256_loadu_si256((__m256i *) (as + i)); };
+        auto st = [&](int i, __m256i x) { _mm256_storeu_si256((__m256i *) (as + i), x); };
+        auto radix2 = [&]() {
+            for (int j = 0; j < n / 2; j += 8) {
+                auto x = ld(j), y = ld(j + n / 2);
+                st(j, add(x, y));
+                st(j + n / 2, sub(x, y));
+            }
+        };
+        int odd = __lg(n) & 1;
+        if (is_inv == 0 && odd) radix2();
+        for (int t = 0, k = __lg(n) / 2; t < k; ++t) {
+            int h = 1 << (is_inv ? t * 2 : (k - 1 - t) * 2), len = h << 2;
+            const auto &rt = is_inv ? B::irt : B::rt;
+            const auto &mr = is_inv ? mirt : mrt;
+            for (int i = 0, s = 0; i < n; i += len, ++s) {
+                mint w1 = rt[s * 2], w2 = rt[s], w3 = w1 * w2;
+                mint *a = as + i;
+                if (h < 8) {
+                    for (int j = 0; j < h; ++j) {
+                        if (is_inv == 0) {
+                            auto a0 = a[j], a1 = a[j + h] * w1, a2 = a[j + h * 2] * w2, a3 = a[j + h * 3] * w3;
+                            auto t0 = a0 + a2, t1 = a0 - a2, t2 = a1 + a3, t3 = (a1 - a3) * im;
+                            a[j] = t0 + t2, a[j + h] = t0 - t2, a[j + h * 2] = t1 + t3, a[j + h * 3] = t1 - t3;
+                        } else {
+                            auto b0 = a[j], b1 = a[j + h], b2 = a[j + h * 2], b3 = a[j + h * 3];
+                            auto t0 = b0 + b1, t2 = b0 - b1, t1 = b2 + b3, t3 = (b2 - b3) * iim;
+                            a[j] = t0 + t1, a[j + h] = (t2 + t3) * w1, a[j + h * 2] = (t0 - t1) * w2, a[j + h * 3] = (t2 - t3) * w3;
+                        }
+                    }
+                    continue;
+                }
+                __m256i v1 = _mm256_set1_epi32(mr[s * 2]), v2 = _mm256_set1_epi32(mr[s]), v3 = _mm256_set1_epi32(mont(w3));
+                for (int j = i; j < i + h; j += 8) {
+                    if (is_inv == 0) {
+                        auto a0 = ld(j), a1 = mul(ld(j + h), v1), a2 = mul(ld(j + h * 2), v2), a3 = mul(ld(j + h * 3), v3);
+                        auto t0 = add(a0, a2), t1 = sub(a0, a2), t2 = add(a1, a3), t3 = mul(sub(a1, a3), vim);
+                        st(j, add(t0, t2)), st(j + h, sub(t0, t2)), st(j + h * 2, add(t1, t3)), st(j + h * 3, sub(t1, t3));
+                    } else {
+                        auto b0 = ld(j), b1 = ld(j + h), b2 = ld(j + h * 2), b3 = ld(j + h * 3);
+                        auto t0 = add(b0, b1), t2 = sub(b0, b1), t1 = add(b2, b3), t3 = mul(sub(b2, b3), viim);
+                        st(j, add(t0, t1)), st(j + h, mul(add(t2, t3), v1)), st(j + h * 2, mul(sub(t0, t1), v2)), st(j + h * 3, mul(sub(t2, t3), v3));
+                    }
+                }
+            }
+        }
+        if (is_inv == 1 && odd) radix2();
+    } /// end-hash
+
+    static void scale(mint *as, int n, u32 c) { // as[i] *= c / 2^32.
+        __m256i vc = _mm256_set1_epi32(c);
+        for (int i = 0; i < n; i += 8) {
+            _mm256_storeu_si256((__m256i *) (as + i), mul(_mm256_loadu_si256((__m256i *) (as + i)), vc));
+        }
+    }
+
+    static void dft(mint *as, int n, int is_inv) {
+        if (n < 64) return B::dft(as, n, is_inv);
+        run(as, n, is_inv);
+        if (is_inv == 1) scale(as, n, mont(mint{1} / n));
+    }
+
+    static void dft(vector<mint> &as, int is_inv) { dft(as.data(), sz(as), is_inv); }
+
+    static vector<mint> conv(const vector<mint> &as, const vector<mint> &bs) { /// start-hash
+        if (min(sz(as), sz(bs)) <= 128) return B::conv(as, bs);
+        int n = sz(as) + sz(bs) - 1, n2 = 1 << __lg(n * 2 - 1);
+        auto xs = as, ys = bs;
+        xs.resize(n2, 0);
+        ys.resize(n2, 0);
+        run(xs.data(), n2, 0);
+        run(ys.data(), n2, 0);
+        for (int i = 0; i < n2; i += 8) { // products come out divided by 2^32, which scale() puts back.
+            auto x = _mm256_loadu_si256((__m256i *) (xs.data() + i)), y = _mm256_loadu_si256((__m256i *) (ys.data() + i));
+            _mm256_storeu_si256((__m256i *) (xs.data() + i), mul(x, y));
+        }
+        run(xs.data(), n2, 1);
+        scale(xs.data(), n2, mont(mont(mint{1} / n2)));
+        xs.resize(n);
+        return xs;
+    } /// end-hash
+};
+#else
+template<class mint = Z>
+using FFTAVX2 = FFT<mint>;
+#endif
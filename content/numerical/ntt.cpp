@@ -1,59 +1,104 @@
 /**
  * Author: Yuhao Yao
  * Date: 23-03-29
- * Description: Number Theoretic Transform. 
+ * Description: Number Theoretic Transform.
  *  class $T$ should have static function $getMod()$ to provide the $mod$. We usually just use $modnum$ as the template parameter.
  *  $g \to  mod~(\max \log(n))$:\\
  *  3 $\to$ 104857601 (22), 167772161 (25), 469762049 (26), 998244353 (23), 1004535809 (21);\\
  *  10 $\to$ 786433 (18);\\
- *  31 $\to$ 2013265921 (27).
+ *  31 $\to$ 2013265921 (27).\\
+ *  Twiddles are cached once in $rt$ / $irt$ ($rt[s]$ is the twiddle of the $s$-th block, shared by every length), and the butterflies are radix-4.
+ *  $dft(as, 0)$ is decimation-in-frequency and leaves the values in bit-reversed order; $dft(as, 1)$ is decimation-in-time and takes them back, so no bit-reversal pass is needed.
+ *  $prepare(n)$ is called by $dft$; call it yourself before transforming from several threads.
+ *  The first half of a length-$2n$ transform is the length-$n$ transform of $as \bmod (x^n - 1)$, which $Poly$ uses to reuse transforms in Newton iterations.
+ *  $middle(as, bs)$ is the middle product (transposed multiplication), computed with one cyclic product of length $\ge |as|$.
  * Usage:
  *  vector<Z> as = FFT.conv(vector<Z>{1, 2, 3}, vector<Z>{2, 3, 4});
  * Time: O(N \log N).
  * Status: tested on https://ac.nowcoder.com/acm/contest/33186/H, https://judge.yosupo.jp/problem/kth_term_of_linearly_recurrent_sequence.
  */
+#pragma once
+
 template<class mint = Z>
 struct FFT {
-    static void dft(vector<mint> &as, int is_inv) { // is_inv == 1 -> idft.
-        static int mod = mint::getMod();
+    inline static vector<mint> rt{1}, irt{1};
+
+    static void prepare(int n) { /// start-hash
+        static const int mod = mint::getMod();
         static mint root = 0;
         if (root == 0) {
             root = 2;
             while (root.pow((mod - 1) / 2) == 1)
                 root += 1; // it is not necessarily a primitive root but lowbit(mod - 1) divides its order.
         }
-
-        int n = sz(as);
-        assert(__builtin_popcount(n) == 1);
-        static vector<int> r;
-        if (sz(r) != n) {
-            r.resize(n);
-            for (int i = 1; i < n; ++i) {
-                r[i] = (r[i >> 1] >> 1) | ((i & 1) << (__builtin_ctz(n) - 1));
+        while (sz(rt) < n / 2 || sz(rt) < 2) {
+            int b = __lg(sz(rt));
+            assert((mod - 1) % (1 << (b + 2)) == 0);
+            mint e = root.pow((mod - 1) >> (b + 2)), ie = mint{1} / e;
+            for (int s = 0; s < 1 << b; ++s) {
+                rt.push_back(rt[s] * e);
+                irt.push_back(irt[s] * ie);
             }
         }
+    } /// end-hash
 
-        for (int i = 1; i < n; ++i) if (r[i] > i) swap(as[i], as[r[i]]);
-        for (int step = 1; step < n; step <<= 1) {
-            mint zeta = root.pow((mod - 1) / (step << 1));
-            if (is_inv) zeta = mint{1} / zeta;
-            vector<mint> ws(step);
-            ws[0] = 1;
-            for (int i = 1; i < step; ++i) ws[i] = ws[i - 1] * zeta;
-            for (int i = 0; i < n; i += step << 1) {
-                for (int j = 0; j < step; ++j) {
-                    auto x = as[i + j], y = as[i + j + step] * ws[j];
-                    as[i + j] = x + y;
-                    as[i + j + step] = x - y;
+    static void dft(mint *as, int n, int is_inv) { /// start-hash
+        assert(__builtin_popcount(n) == 1);
+        prepare(n);
+        const mint im = rt[1], iim = irt[1];
+        int odd = __lg(n) & 1;
+        if (is_inv == 0) {
+            if (odd) {
+                for (int j = 0; j < n / 2; ++j) {
+                    auto x = as[j], y = as[j + n / 2];
+                    as[j] = x + y;
+                    as[j + n / 2] = x - y;
+                }
+            }
+            for (int len = n >> odd; len >= 4; len >>= 2) {
+                int h = len >> 2;
+                for (int i = 0, s = 0; i < n; i += len, ++s) {
+                    mint w1 = rt[s * 2], w2 = rt[s], w3 = w1 * w2;
+                    mint *a = as + i;
+                    for (int j = 0; j < h; ++j) {
+                        auto a0 = a[j], a1 = a[j + h] * w1, a2 = a[j + h * 2] * w2, a3 = a[j + h * 3] * w3;
+                        auto t0 = a0 + a2, t1 = a0 - a2, t2 = a1 + a3, t3 = (a1 - a3) * im;
+                        a[j] = t0 + t2;
+                        a[j + h] = t0 - t2;
+                        a[j + h * 2] = t1 + t3;
+                        a[j + h * 3] = t1 - t3;
+                    }
+                }
+            }
+        } else {
+            for (int len = 4; len <= (n >> odd); len <<= 2) {
+                int h = len >> 2;
+                for (int i = 0, s = 0; i < n; i += len, ++s) {
+                    mint w1 = irt[s * 2], w2 = irt[s], w3 = w1 * w2;
+                    mint *a = as + i;
+                    for (int j = 0; j < h; ++j) {
+                        auto b0 = a[j], b1 = a[j + h], b2 = a[j + h * 2], b3 = a[j + h * 3];
+                        auto t0 = b0 + b1, t2 = b0 - b1, t1 = b2 + b3, t3 = (b2 - b3) * iim;
+                        a[j] = t0 + t1;
+                        a[j + h] = (t2 + t3) * w1;
+                        a[j + h * 2] = (t0 - t1) * w2;
+                        a[j + h * 3] = (t2 - t3) * w3;
+                    }
+                }
+            }
+            if (odd) {
+                for (int j = 0; j < n / 2; ++j) {
+                    auto x = as[j], y = as[j + n / 2];
+                    as[j] = x + y;
+                    as[j + n / 2] = x - y;
                 }
             }
-        }
-
-        if (is_inv == 1) {
             auto inv = mint{1} / n;
-            for (auto &x: as) x *= inv;
+            for (int i = 0; i < n; ++i) as[i] *= inv;
         }
-    }
+    } /// end-hash
+
+    static void dft(vector<mint> &as, int is_inv) { dft(as.data(), sz(as), is_inv); } // is_inv == 1 -> idft.
 
     static vector<mint> conv(const vector<mint> &as, const vector<mint> &bs) {
         if (min(sz(as), sz(bs)) <= 128) {
@@ -68,7 +113,7 @@ struct FFT {
             xs.resize(n2, 0);
             ys.resize(n2, 0);
             dft(xs, 0);
-            if (as == bs) ys = xs;
+            if (&as == &bs) ys = xs;
             else dft(ys, 0);
             for (int i = 0; i < n2; ++i) xs[i] *= ys[i];
             dft(xs, 1);
@@ -76,4 +121,27 @@ struct FFT {
             return xs;
         }
     }
-};
\ No newline at end of file
+
+    // Middle product: cs[i] = \sum_j as[i + j] * bs[sz(bs) - 1 - j], i.e. coefficients [sz(bs) - 1, sz(as)) of as * bs.
+    // A cyclic product of length >= sz(as) suffices since the wraparound only lands below sz(bs) - 1.
+    static vector<mint> middle(const vector<mint> &as, const vector<mint> &bs) { /// start-hash
+        int n = sz(as), m = sz(bs);
+        assert(0 < m && m <= n);
+        if (min(m, n - m + 1) <= 64) {
+            vector<mint> cs(n - m + 1);
+            for (int i = 0; i <= n - m; ++i)
+                for (int j = 0; j < m; ++j)
+                    cs[i] += as[i + j] * bs[m - 1 - j];
+            return cs;
+        }
+        int n2 = 1 << __lg(n * 2 - 1);
+        auto xs = as, ys = bs;
+        xs.resize(n2, 0);
+        ys.resize(n2, 0);
+        dft(xs, 0);
+        dft(ys, 0);
+        for (int i = 0; i < n2; ++i) xs[i] *= ys[i];
+        dft(xs, 1);
+        return vector<mint>(xs.begin() + m - 1, xs.begin() + n);
+    } /// end-hash
+};
@@ -0,0 +1,53 @@
+/**
+ * Author: Boboge
+ * Date: 26-10-17
+ * Description: Semi-online convolution $h = f * g$ where $g$ is known in advance and $f_i$ arrives one at a time (e.g. $f_{i + 1}$ depends on $h_{i + 1}$).
+ *  $push(f_i)$ appends $f_i$ and returns $\sum_{j \le i} f_j g_{i + 1 - j}$, i.e. everything of $h_{i + 1}$ except $f_{i + 1} g_0$. After the push $hs[i]$ is the full $h_i$.
+ *  When $i + 1$ is a multiple of $s$, the block $f[i + 1 - s, i]$ is multiplied by $g[s, 2s)$; the transforms of these pieces of $g$ are cached per level.
+ *  Entries of $g$ past $|gs|$ are treated as $0$.
+ * Usage:
+ *  OnlineConvolution<Z> oc(gs); // f_0 = 1, f_{i + 1} = \sum_{j \le i} f_j g_{i + 1 - j}.
+ *  vector<Z> fs{1};
+ *  for (int i = 0; i < n; ++i) fs.push_back(oc.push(fs[i]));
+ * Time: O(\log^2 N) amortized per push.
+ * Status: checked against brute force on random inputs.
+ */
+#include "ntt.cpp"
+
+template<class mint = Z, class NTT = FFT<mint>>
+struct OnlineConvolution {
+    vector<mint> fs, gs, hs;
+    vector<vector<mint>> gdft; // gdft[k]: dft of gs[2^k, 2^{k + 1}) padded to length 2^{k + 1}.
+
+    OnlineConvolution(const vector<mint> &gs) : gs(gs) {}
+
+    mint push(mint f) { /// start-hash
+        int i = sz(fs);
+        fs.push_back(f);
+        if (sz(hs) < i + 2) hs.resize(i + 2);
+        if (!gs.empty()) hs[i] += f * gs[0];
+        for (int k = 0, s = 1; (i + 1) % s == 0 && s < sz(gs); ++k, s <<= 1) {
+            int b = i + 1 - s, len = min(s * 2, sz(gs)) - s; // f[b, b + s) * g[s, s + len) -> h[b + s, ...).
+            if (sz(hs) < b + s * 2 + len) hs.resize(b + s * 2 + len);
+            if (s <= 32) {
+                for (int x = 0; x < s; ++x)
+                    for (int y = 0; y < len; ++y)
+                        hs[b + s + x + y] += fs[b + x] * gs[s + y];
+                continue;
+            }
+            if (sz(gdft) <= k) gdft.resize(k + 1);
+            if (gdft[k].empty()) {
+                gdft[k].assign(gs.begin() + s, gs.begin() + s + len);
+                gdft[k].resize(s * 2);
+                NTT::dft(gdft[k], 0);
+            }
+            vector<mint> xs(fs.begin() + b, fs.begin() + b + s);
+            xs.resize(s * 2);
+            NTT::dft(xs, 0);
+            for (int j = 0; j < s * 2; ++j) xs[j] *= gdft[k][j];
+            NTT::dft(xs, 1);
+            for (int j = 0; j < s + len - 1; ++j) hs[b + s + j] += xs[j];
+        }
+        return hs[i + 1];
+    } /// end-hash
+};
@@ -0,0 +1,150 @@
+/**
+ * Author: Boboge
+ * Date: 26-10-17
+ * Description: Allocation-free power series operations on raw buffers.
+ *  $Scratch<T>$ is a thread-local stack of blocks; a $Frame$ releases everything taken after it was opened, and the blocks are kept for the next call, so repeated calls do not touch the heap.
+ *  $mul\_trunc(a, na, b, nb, c, k)$: $c[0, k) = a b \bmod x^k$. $inv(a, n, c, k)$ and $exp(a, n, c, k)$: Newton iterations on transforms, working in the arena; $Poly::inv$ and $Poly::exp$ call them. The output may alias the input.
+ *  The $vector$ overloads work in place and only allocate when the vector has to grow.
+ * Usage:
+ *  PolyOps<Z>::exp(as, k); // as = exp(as) mod x^k.
+ *  PolyOps<Z>::mul_trunc(as.data(), sz(as), bs.data(), sz(bs), cs.data(), k);
+ * Time: O(N \log N).
+ * Status: checked against the vector Newton iterations and naive products on random inputs; no allocations after the first call of a given size.
+ */
+#pragma once
+#include "ntt.cpp"
+
+template<class T>
+struct Scratch {
+    inline static thread_local vector<vector<T>> blocks;
+    inline static thread_local int cur = 0, pos = 0;
+
+    static T *get(int n) { // uninitialized.
+        while (cur < sz(blocks) && pos + n > sz(blocks[cur])) cur++, pos = 0;
+        if (cur == sz(blocks)) blocks.emplace_back(max(n, blocks.empty() ? 1 << 16 : sz(blocks.back()) * 2));
+        T *p = blocks[cur].data() + pos;
+        pos += n;
+        return p;
+    }
+
+    struct Frame {
+        int c, p;
+        Frame() : c(cur), p(pos) {}
+        ~Frame() { cur = c, pos = p; }
+    };
+};
+
+template<class T = Z, class FFT = FFT<T>>
+struct PolyOps {
+    using S = Scratch<T>;
+
+    static void mul_trunc(const T *a, int na, const T *b, int nb, T *c, int k) { /// start-hash
+        typename S::Frame fr;
+        na = min(na, k), nb = min(nb, k);
+        if (na == 0 || nb == 0) return fill(c, c + k, T{0});
+        int n = min(na + nb - 1, k);
+        if (min(na, nb) <= 32) {
+            T *r = S::get(n);
+            fill(r, r + n, T{0});
+            for (int i = 0; i < na; ++i)
+                for (int j = 0; j < nb && i + j < n; ++j) r[i + j] += a[i] * b[j];
+            copy(r, r + n, c);
+        } else {
+            int L = 1 << __lg((na + nb - 1) * 2 - 1);
+            T *x = S::get(L), *y = S::get(L);
+            copy(a, a + na, x), fill(x + na, x + L, T{0});
+            copy(b, b + nb, y), fill(y + nb, y + L, T{0});
+            FFT::dft(x, L, 0), FFT::dft(y, L, 0);
+            for (int i = 0; i < L; ++i) x[i] *= y[i];
+            FFT::dft(x, L, 1);
+            copy(x, x + n, c);
+        }
+        fill(c + n, c + k, T{0});
+    } /// end-hash
+
+    // Newton iteration; the cyclic product f * g of length 2m is exact on [m, 2m) since f * g = 1 mod x^m.
+    static void inv(const T *a, int n, T *c, int k) { /// start-hash
+        assert(n > 0 && k > 0);
+        typename S::Frame fr;
+        int K = 1 << __lg(k * 2 - 1);
+        T *g = S::get(K), *f = S::get(K), *h = S::get(K);
+        g[0] = T{1} / a[0];
+        for (int m = 1; m < k; m <<= 1) {
+            int l = min(n, m * 2);
+            copy(a, a + l, f), fill(f + l, f + m * 2, T{0});
+            copy(g, g + m, h), fill(h + m, h + m * 2, T{0});
+            FFT::dft(f, m * 2, 0), FFT::dft(h, m * 2, 0);
+            for (int i = 0; i < m * 2; ++i) f[i] *= h[i];
+            FFT::dft(f, m * 2, 1);
+            fill(f, f + m, T{0});
+            FFT::dft(f, m * 2, 0);
+            for (int i = 0; i < m * 2; ++i) f[i] *= h[i];
+            FFT::dft(f, m * 2, 1);
+            for (int i = m; i < m * 2; ++i) g[i] = -f[i];
+        }
+        copy(g, g + k, c);
+    } /// end-hash
+
+    // Newton iteration keeping $b = exp(a) \bmod x^m$ together with $cs = b^{-1} \bmod x^m$ and reusing their transforms.
+    static void exp(const T *a, int n, T *c, int k) { /// start-hash
+        assert(k > 0 && (n == 0 || a[0] == T{0}));
+        typename S::Frame fr;
+        int K = max(2, 1 << __lg(k * 2 - 1));
+        T *b = S::get(K), *cs = S::get(K), *ys = S::get(K), *ws = S::get(K), *zs = S::get(K), *xs = S::get(K);
+        b[0] = 1, b[1] = n > 1 ? a[1] : T{0};
+        cs[0] = 1, zs[0] = zs[1] = 1;
+        for (int m = 2; m < k; m <<= 1) {
+            copy(b, b + m, ys), fill(ys + m, ys + m * 2, T{0});
+            FFT::dft(ys, m * 2, 0);
+
+            for (int i = 0; i < m; ++i) ws[i] = ys[i] * zs[i];
+            FFT::dft(ws, m, 1);
+            fill(ws, ws + m / 2, T{0});
+            FFT::dft(ws, m, 0);
+            for (int i = 0; i < m; ++i) ws[i] *= -zs[i];
+            FFT::dft(ws, m, 1);
+            copy(ws + m / 2, ws + m, cs + m / 2);
+            copy(cs, cs + m, zs), fill(zs + m, zs + m * 2, T{0});
+            FFT::dft(zs, m * 2, 0);
+
+            fill(xs, xs + m, T{0});
+            for (int i = 1; i < min(n, m); ++i) xs[i - 1] = a[i] * i;
+            FFT::dft(xs, m, 0);
+            for (int i = 0; i < m; ++i) xs[i] *= ys[i];
+            FFT::dft(xs, m, 1);
+            for (int i = 1; i < m; ++i) xs[i - 1] -= b[i] * i;
+            for (int i = 0; i < m - 1; ++i) xs[m + i] = xs[i], xs[i] = 0;
+            xs[m * 2 - 1] = 0;
+            FFT::dft(xs, m * 2, 0);
+            for (int i = 0; i < m * 2; ++i) xs[i] *= zs[i];
+            FFT::dft(xs, m * 2, 1);
+            for (int i = m * 2 - 1; i >= m; --i) xs[i] = xs[i - 1] / i;
+            for (int i = m; i < min(n, m * 2); ++i) xs[i] += a[i];
+            fill(xs, xs + m, T{0});
+            FFT::dft(xs, m * 2, 0);
+            for (int i = 0; i < m * 2; ++i) xs[i] *= ys[i];
+            FFT::dft(xs, m * 2, 1);
+            copy(xs + m, xs + m * 2, b + m);
+        }
+        copy(b, b + k, c);
+    } /// end-hash
+
+    static void mul_trunc(vector<T> &as, const vector<T> &bs, int k) {
+        int n = sz(as);
+        as.resize(max(n, k));
+        mul_trunc(as.data(), n, bs.data(), sz(bs), as.data(), k);
+        as.resize(k);
+    }
+    static void inv(vector<T> &as, int k) {
+        int n = sz(as);
+        as.resize(max(n, k));
+        inv(as.data(), n, as.data(), k);
+        as.resize(k);
+    }
+    static void exp(vector<T> &as, int k) {
+        int n = sz(as);
+        as.resize(max(n, k));
+        exp(as.data(), n, as.data(), k);
+        as.resize(k);
+    }
+};
@@ -2,11 +2,17 @@
  * Author: Yuhao Yao
  * Date: 23-03-28
  * Description: Basic polynomial struct. Usually we use $modnum$ as template parameter. $inv(k)$ gives the inverse of the polynomial $mod~ x^k$ (by default $k$ is the highest power plus one).
+ *  $inv$ and $exp$ are the $PolyOps$ kernels (about $10$ and $17$ length-$k$ NTTs in total), so $FFT$ must provide $dft$.
+ *  $divmod(B)$ returns $\{Q, R\}$ with $A = QB + R$, $\deg R < \deg B$ (the leading coefficient of $B$ must be nonzero); $sqrt(k)$ returns $\{false, \{\}\}$ if there is no square root $mod~ x^k$; $shift(c)$ returns $A(x + c)$.
  * Status: 
  *  inv() tested on https://www.luogu.com.cn/problem/P4238, https://judge.yosupo.jp/problem/kth_term_of_linearly_recurrent_sequence.
  *  ln() tested on https://www.luogu.com.cn/problem/P4725.
  *  exp() tested on https://www.luogu.com.cn/problem/P4726, https://judge.yosupo.jp/problem/exp_of_formal_power_series.
  */
+#pragma once
+#include "poly-arena.cpp"
+#include "../number-theory/mod-sqrt.cpp"
+
 template<class T = Z, class FFT = FFT<T>>
 struct Poly : vector<T> {
     using poly = Poly;
@@ -42,8 +48,7 @@ struct Poly : vector<T> {
     }
 
     friend poly operator*(const poly &as, const poly &bs) {
-        auto cs = as;
-        return cs *= bs;
+        return FFT::conv(as, bs);
     }
 
     friend poly &operator*=(poly &as, const T &b) {
@@ -81,14 +86,10 @@ struct Poly : vector<T> {
     }
 
     poly inv(int k = 0) const { /// start-hash
-        const poly &as = *this;
-        assert(!as.empty());
-        if (k == 0) k = sz(as);
-        poly res{T{1} / as[0]};
-        for (int m = 2; m < k * 2; m <<= 1) {
-            res = res * 2 - (res * res * as.modxk(m)).modxk(m);
-        }
-        res.resize(k);
+        assert(!this->empty());
+        if (k == 0) k = sz(*this);
+        poly res(k);
+        PolyOps<T, FFT>::inv(this->data(), sz(*this), res.data(), k);
         return res;
     } /// end-hash
 
@@ -99,17 +100,12 @@ struct Poly : vector<T> {
         return (as.derivative() * as.inv()).modxk(sz(as) - 1).integral();
     }
 
-    poly exp(int k = 0) const {
-        const poly &as = *this;
-        if (k == 0) k = sz(as);
-        assert(k > 0 && (as.empty() || as[0] == T{0})); // be cautious when T is float or double.
-        poly res{1};
-        for (int m = 2; m < k * 2; m <<= 1) {
-            res = res - (res * (res.ln(m) - as.modxk(m))).modxk(m);
-        }
-        res.resize(k);
+    poly exp(int k = 0) const { /// start-hash
+        if (k == 0) k = sz(*this);
+        poly res(k);
+        PolyOps<T, FFT>::exp(this->data(), sz(*this), res.data(), k);
         return res;
-    }
+    } /// end-hash
 
     poly pow(int k) const {
         int d = 0;
@@ -127,4 +123,71 @@ struct Poly : vector<T> {
         fk.modxk(rem_siz);
         return fk;
     }
+
+    // Q from the reversed series, R = A - QB computed modulo x^L - 1 for L >= deg B, which is exact since deg R < L.
+    pair<poly, poly> divmod(const poly &bs) const { /// start-hash
+        const poly &as = *this;
+        int n = sz(as), m = sz(bs);
+        assert(m > 0 && bs.back() != T{0});
+        if (n < m) return {poly{}, as};
+        int k = n - m + 1;
+        poly ra(as.rbegin(), as.rbegin() + k), rb(bs.rbegin(), bs.rend());
+        poly qs = (ra * rb.inv(k)).modxk(k);
+        reverse(all(qs));
+        if (m == 1) return {qs, poly{}};
+        int L = 1 << __lg((m - 1) * 2 - 1);
+        vector<T> xs(L), ys(L), rs(L);
+        for (int i = 0; i < k; ++i) xs[i & (L - 1)] += qs[i];
+        for (int i = 0; i < m; ++i) ys[i & (L - 1)] += bs[i];
+        for (int i = 0; i < n; ++i) rs[i & (L - 1)] += as[i];
+        FFT::dft(xs, 0);
+        FFT::dft(ys, 0);
+        for (int i = 0; i < L; ++i) xs[i] *= ys[i];
+        FFT::dft(xs, 1);
+        poly r(m - 1);
+        for (int i = 0; i < m - 1; ++i) r[i] = rs[i] - xs[i];
+        return {qs, r};
+    } /// end-hash
+
+    // Newton: g <- (g + A / g) / 2.
+    pair<bool, poly> sqrt(int k = 0) const { /// start-hash
+        const poly &as = *this;
+        if (k == 0) k = sz(as);
+        int d = 0;
+        while (d < sz(as) && as[d] == T{0}) d++;
+        if (d >= k || d == sz(as)) return {true, poly(k, 0)};
+        if (d & 1) return {false, poly{}};
+        auto [ok, r] = ModSqrt(as[d]);
+        if (!ok) return {false, poly{}};
+        int k2 = k - d / 2;
+        poly f(as.begin() + d, as.end()), g{r};
+        const T inv2 = T{1} / 2;
+        for (int m = 1; m < k2; m <<= 1) {
+            g = (g + (f.modxk(m * 2) * g.inv(m * 2)).modxk(m * 2)) * inv2;
+        }
+        g.resize(k2);
+        g.insert(g.begin(), d / 2, T{0});
+        return {true, g};
+    } /// end-hash
+
+    // A(x + c): (j! g_j) = \sum_i (i! f_i) c^{i - j} / (i - j)!, one product of reversed sequences.
+    poly shift(T c) const { /// start-hash
+        int n = sz(*this);
+        if (n == 0) return {};
+        vector<T> fac(n, 1), ifac(n);
+        for (int i = 1; i < n; ++i) fac[i] = fac[i - 1] * i;
+        ifac[n - 1] = T{1} / fac[n - 1];
+        for (int i = n - 1; i > 0; --i) ifac[i - 1] = ifac[i] * i;
+        poly as(n), bs(n);
+        T pw = 1;
+        for (int i = 0; i < n; ++i) {
+            as[n - 1 - i] = (*this)[i] * fac[i];
+            bs[i] = pw * ifac[i];
+            pw *= c;
+        }
+        as = (as * bs).modxk(n);
+        reverse(all(as));
+        for (int i = 0; i < n; ++i) as[i] *= ifac[i];
+        return as;
+    } /// end-hash
 };
\ No newline at end of file
@@ -0,0 +1,173 @@
+/**
+ * Author: Boboge
+ * Date: 26-10-17
+ * Description: Bounded revised simplex for sparse LPs: maximize $c^\top x$ subject to $rl_i \le (Ax)_i \le ru_i$ and $cl_j \le x_j \le cu_j$ (bounds may be $\pm inf$).
+ *  Every row gets a logical variable $s_i = -(Ax)_i$, so the columns of $[A~I]$ are the variables and the first basis is all logicals. Nonbasic variables sit at a bound ($0$ if free).
+ *  The basis inverse is kept in product form (one eta column per pivot) and rebuilt from the logical basis every $64$ pivots. Pricing is Devex; phase 1 minimizes the sum of infeasibilities of the current basis, so no artificial variables are needed.
+ *  $solve()$ returns $0$ if infeasible, $1$ if optimal ($x$, $obj$ are set), $2$ if unbounded. Change $c$, $cl$, $cu$, $rl$, $ru$ and call $solve()$ again to warm start from the last basis.
+ * Usage:
+ *  RevisedSimplex<double> lp(m, n, {{0, 0, 1.}, {0, 1, 2.}}); // (row, column, value)
+ *  lp.c = {1, 1}; lp.ru[0] = 4;
+ *  int res = lp.solve();
+ * Time: O(nnz + m) per pivot plus the eta file, in practice $O(m)$ to $O(m + n)$ pivots.
+ * Status: checked against the tableau $Simplex$ on random inputs.
+ */
+template<class T = double>
+struct RevisedSimplex {
+	static constexpr T inf = numeric_limits<T>::infinity(), eps = 1e-9;
+	int m, n, N;
+	vi cs, ri; // columns of A in CSC form.
+	vector<T> cv, c, cl, cu, rl, ru, lo, hi, xv, w, x;
+	vi head, st; // st[j]: -1 basic, 0 at lower, 1 at upper, 2 free at 0.
+	vi er, es, ei; // eta file: er[k] is the pivot position, (ei, ev)[es[k], es[k + 1]) the other entries.
+	int fresh = 0; // size of the eta file right after the last refactor.
+	vector<T> ep, ev;
+	T obj = 0;
+
+	RevisedSimplex(int m, int n, const vector<tuple<int, int, T>> &as) : m(m), n(n), N(n + m), cs(n + 1),
+		c(n), cl(n, 0), cu(n, inf), rl(m, -inf), ru(m, inf), lo(N), hi(N), xv(N), w(N, 1), head(m), st(N, 0) {
+		for (auto &[i, j, v]: as) cs[j + 1]++;
+		rep(j, 0, n - 1) cs[j + 1] += cs[j];
+		ri.resize(sz(as)), cv.resize(sz(as));
+		vi p(cs.begin(), cs.end() - 1);
+		for (auto &[i, j, v]: as) ri[p[j]] = i, cv[p[j]++] = v;
+		rep(i, 0, m - 1) head[i] = n + i, st[n + i] = -1;
+		es.push_back(0);
+	}
+
+	void ftran(vector<T> &v) {
+		rep(k, 0, sz(er) - 1) {
+			int r = er[k];
+			if (v[r] == 0) continue;
+			T t = v[r] /= ep[k];
+			rep(e, es[k], es[k + 1] - 1) v[ei[e]] -= ev[e] * t;
+		}
+	}
+
+	void btran(vector<T> &y) {
+		revrep(k, 0, sz(er) - 1) {
+			T s = y[er[k]];
+			rep(e, es[k], es[k + 1] - 1) s -= ev[e] * y[ei[e]];
+			y[er[k]] = s / ep[k];
+		}
+	}
+
+	void column(int j, vector<T> &v) {
+		fill(all(v), 0);
+		if (j >= n) v[j - n] = 1;
+		else rep(e, cs[j], cs[j + 1] - 1) v[ri[e]] += cv[e];
+	}
+
+	T dot(const vector<T> &y, int j) {
+		if (j >= n) return y[j - n];
+		T s = 0;
+		rep(e, cs[j], cs[j + 1] - 1) s += y[ri[e]] * cv[e];
+		return s;
+	}
+
+	void pushEta(int r, const vector<T> &d) {
+		er.push_back(r), ep.push_back(d[r]);
+		rep(i, 0, m - 1) if (i != r && d[i] != 0) ei.push_back(i), ev.push_back(d[i]);
+		es.push_back(sz(ei));
+	}
+
+	// Rebuild the eta file from the logical basis and recompute the basic values.
+	void refactor() { /// start-hash
+		er.clear(), ep.clear(), ei.clear(), ev.clear(), es.assign(1, 0);
+		vi nh(m, -1), str;
+		rep(r, 0, m - 1) if (head[r] >= n) nh[head[r] - n] = head[r];
+		else str.push_back(head[r]);
+		vector<T> d(m);
+		for (int j: str) {
+			column(j, d), ftran(d);
+			int r = -1;
+			rep(i, 0, m - 1) if (nh[i] == -1 && (r == -1 || abs(d[i]) > abs(d[r]))) r = i;
+			if (abs(d[r]) < eps) { // dependent column, leaves the basis at a bound (free: at 0).
+				st[j] = lo[j] > -inf ? 0 : hi[j] < inf ? 1 : 2;
+				xv[j] = st[j] == 0 ? lo[j] : st[j] == 1 ? hi[j] : 0;
+				continue;
+			}
+			pushEta(r, d), nh[r] = j;
+		}
+		rep(r, 0, m - 1) if (nh[r] == -1) nh[r] = n + r, st[n + r] = -1;
+		head = nh, fresh = sz(er);
+		fill(all(d), 0);
+		rep(j, 0, N - 1) if (st[j] != -1 && xv[j] != 0) {
+			if (j >= n) d[j - n] -= xv[j];
+			else rep(e, cs[j], cs[j + 1] - 1) d[ri[e]] -= cv[e] * xv[j];
+		}
+		ftran(d);
+		rep(r, 0, m - 1) xv[head[r]] = d[r];
+	} /// end-hash
+
+	int solve() { /// start-hash
+		rep(j, 0, n - 1) lo[j] = cl[j], hi[j] = cu[j];
+		rep(i, 0, m - 1) lo[n + i] = -ru[i], hi[n + i] = -rl[i];
+		rep(j, 0, N - 1) if (st[j] != -1) {
+			if (st[j] == 1 && hi[j] == inf) st[j] = 0;
+			if (st[j] == 0 && lo[j] == -inf) st[j] = hi[j] < inf ? 1 : 2;
+			if (st[j] == 2 && lo[j] > -inf) st[j] = 0;
+			xv[j] = st[j] == 0 ? lo[j] : st[j] == 1 ? hi[j] : 0;
+		}
+		refactor();
+		vector<T> y(m), d(m), rho(m);
+		while (1) {
+			if (sz(er) - fresh >= 64) refactor();
+			bool feas = 1;
+			rep(r, 0, m - 1) {
+				int b = head[r];
+				y[r] = xv[b] < lo[b] - eps ? (feas = 0, -1) : xv[b] > hi[b] + eps ? (feas = 0, 1) : 0;
+			}
+			if (feas) rep(r, 0, m - 1) y[r] = head[r] < n ? -c[head[r]] : 0;
+			btran(y);
+			int q = -1, dir = 0;
+			T best = 0;
+			rep(j, 0, N - 1) if (st[j] != -1 && lo[j] < hi[j]) {
+				T dj = (feas && j < n ? -c[j] : 0) - dot(y, j);
+				int s = dj < -eps && st[j] != 1 ? 1 : dj > eps && st[j] != 0 ? -1 : 0;
+				if (s && dj * dj > best * w[j]) best = dj * dj / w[j], q = j, dir = s;
+			}
+			if (q == -1) break;
+			column(q, d), ftran(d);
+			T t = hi[q] - lo[q];
+			int r = -1;
+			rep(i, 0, m - 1) if (abs(d[i]) > eps) {
+				int b = head[i];
+				T del = -dir * d[i], lim = inf;
+				if (del > 0) lim = xv[b] < lo[b] - eps ? lo[b] : xv[b] <= hi[b] + eps ? hi[b] : inf;
+				else lim = xv[b] > hi[b] + eps ? hi[b] : xv[b] >= lo[b] - eps ? lo[b] : -inf;
+				T ti = max<T>((lim - xv[b]) / del, 0);
+				if (ti < t - eps || (ti < t + eps && r != -1 && abs(d[i]) > abs(d[r]))) t = ti, r = i;
+			}
+			if (t == inf) {
+				if (feas) return 2;
+				return 0;
+			}
+			xv[q] += dir * t;
+			rep(i, 0, m - 1) xv[head[i]] -= dir * t * d[i];
+			if (r == -1) {
+				st[q] ^= 1;
+				continue;
+			}
+			int b = head[r];
+			T ar = d[r];
+			fill(all(rho), 0), rho[r] = 1, btran(rho);
+			rep(j, 0, N - 1) if (st[j] != -1 && j != q) {
+				T a = dot(rho, j) / ar;
+				w[j] = max(w[j], a * a * w[q]);
+			}
+			w[b] = max<T>(w[q] / (ar * ar), 1);
+			st[b] = -dir * d[r] > 0 ? (xv[b] >= hi[b] - eps ? 1 : 0) : (xv[b] <= lo[b] + eps ? 0 : 1);
+			xv[b] = st[b] ? hi[b] : lo[b];
+			st[q] = -1, head[r] = q;
+			pushEta(r, d);
+		}
+		rep(r, 0, m - 1) {
+			int b = head[r];
+			if (xv[b] < lo[b] - eps * 10 || xv[b] > hi[b] + eps * 10) return 0;
+		}
+		x.assign(xv.begin(), xv.begin() + n), obj = 0;
+		rep(j, 0, n - 1) obj += c[j] * x[j];
+		return 1;
+	} /// end-hash
+};
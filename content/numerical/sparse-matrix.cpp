@@ -0,0 +1,139 @@
+/**
+ * Author: Boboge
+ * Date: 26-10-17
+ * Description: Sparse matrix over $\mathbb{F}_{mod}$ ($mod < 2^{30}$ prime, and large) in CSR form, with Wiedemann's algorithm on top of $BerlekampMassey$. Monte Carlo, each call errs with probability about $n / mod$.
+ *  $solve(b)$: $x$ with $A x = b$ for square nonsingular $A$. If $f = \sum_j rec_j x^{t - j}$ annihilates $b$ then $x = -\frac{1}{rec_t} \sum_{j < t} rec_j A^{t - 1 - j} b$, and the answer is checked. Returns $\{false, \{\}\}$ if $A$ looks singular.
+ *  $det()$: the characteristic polynomial of $A D$ for a random diagonal $D$ is its minimal polynomial w.h.p.
+ *  $rank()$: the minimal polynomial of $D_1 A^T D_2 A D_1$ has degree $rank$, or $rank + 1$ if $x$ divides it.
+ *  Only $A$ (and the sequences) are stored; duplicate entries are added up.
+ * Usage:
+ *  SparseMatrix<998244353> A(n, n, {{0, 1, 5}, {1, 0, 2}}); // (row, column, value)
+ *  auto [ok, x] = A.solve(b);
+ * Time: O(n (n + nnz)).
+ * Status: checked against dense elimination on random inputs.
+ */
+#include "berlekamp-massey.cpp"
+
+template<int mod>
+struct SparseMatrix {
+	int n, m;
+	vi st, col, val;
+	inline static mt19937_64 rng{(u64) chrono::steady_clock::now().time_since_epoch().count()};
+
+	SparseMatrix(int n, int m, const vector<array<int, 3>> &es) : n(n), m(m), st(n + 1), col(sz(es)), val(sz(es)) {
+		for (auto &[r, c, v]: es) st[r + 1]++;
+		rep(i, 0, n - 1) st[i + 1] += st[i];
+		vi pos(st.begin(), st.end() - 1);
+		for (auto &[r, c, v]: es) col[pos[r]] = c, val[pos[r]++] = (v % mod + mod) % mod;
+	}
+
+	static int rnd() { return rng() % (mod - 1) + 1; }
+
+	static i64 mPow(i64 a, i64 k) {
+		i64 res = 1;
+		for (; k; k >>= 1, a = a * a % mod) if (k & 1) res = res * a % mod;
+		return res;
+	}
+
+	// y = A x, at most 16 products between reductions.
+	void mul(const vi &x, vi &y) const { /// start-hash
+		y.resize(n);
+		rep(i, 0, n - 1) {
+			u64 s = 0;
+			for (int k = st[i], c = 0; k < st[i + 1]; ++k) {
+				s += (u64) val[k] * x[col[k]];
+				if (++c == 16) s %= mod, c = 0;
+			}
+			y[i] = s % mod;
+		}
+	} /// end-hash
+
+	// y = A^T x.
+	void mulT(const vi &x, vi &y) const {
+		y.assign(m, 0);
+		rep(i, 0, n - 1) for (int k = st[i]; k < st[i + 1]; ++k)
+			y[col[k]] = (y[col[k]] + (u64) val[k] * x[i]) % mod;
+	}
+
+	static int dot(const vi &a, const vi &b) {
+		u64 s = 0;
+		rep(i, 0, sz(a) - 1) {
+			s += (u64) a[i] * b[i];
+			if ((i & 15) == 15) s %= mod;
+		}
+		return s % mod;
+	}
+
+	// Minimal polynomial of u^T M^i v (i < 2N) for a random u; apply(v) replaces v by M v.
+	template<class F>
+	static vi minPoly(vi v, F apply) { /// start-hash
+		int N = sz(v);
+		vi u(N), s(N * 2);
+		for (auto &x: u) x = rnd();
+		rep(i, 0, N * 2 - 1) {
+			s[i] = dot(u, v);
+			if (i < N * 2 - 1) apply(v);
+		}
+		return BerlekampMassey<mod>(s).getRec();
+	} /// end-hash
+
+	pair<bool, vi> solve(const vi &b) const { /// start-hash
+		assert(n == m && sz(b) == n);
+		vi x(n), tmp;
+		rep(it, 0, 2) {
+			vi rec = minPoly(b, [&](vi &v) { mul(v, tmp), v.swap(tmp); });
+			int t = sz(rec) - 1;
+			if (rec[t] == 0) continue;
+			fill(all(x), 0);
+			rep(j, 0, t - 1) {
+				mul(x, tmp);
+				rep(i, 0, n - 1) x[i] = (tmp[i] + (u64) rec[j] * b[i]) % mod;
+			}
+			i64 c = mod - mPow(rec[t], mod - 2);
+			for (auto &y: x) y = y * c % mod;
+			mul(x, tmp);
+			if (tmp == b) return {true, x};
+		}
+		return {false, {}};
+	} /// end-hash
+
+	int det() const { /// start-hash
+		assert(n == m);
+		vi d(n), tmp;
+		rep(it, 0, 1) {
+			for (auto &x: d) x = rnd();
+			vi v(n);
+			for (auto &x: v) x = rnd();
+			vi rec = minPoly(v, [&](vi &v) {
+				rep(i, 0, n - 1) v[i] = (u64) v[i] * d[i] % mod;
+				mul(v, tmp), v.swap(tmp);
+			});
+			if (sz(rec) <= n) continue;
+			i64 res = n % 2 ? (mod - rec[n]) % mod : rec[n], pd = 1;
+			for (auto x: d) pd = pd * x % mod;
+			return res * mPow(pd, mod - 2) % mod;
+		}
+		return 0;
+	} /// end-hash
+
+	int rank() const { /// start-hash
+		vi d1(m), d2(n), w;
+		int res = 0;
+		rep(it, 0, 1) {
+			for (auto &x: d1) x = rnd();
+			for (auto &x: d2) x = rnd();
+			vi v(m);
+			for (auto &x: v) x = rnd();
+			vi rec = minPoly(v, [&](vi &v) {
+				rep(i, 0, m - 1) v[i] = (u64) v[i] * d1[i] % mod;
+				mul(v, w);
+				rep(i, 0, n - 1) w[i] = (u64) w[i] * d2[i] % mod;
+				mulT(w, v);
+				rep(i, 0, m - 1) v[i] = (u64) v[i] * d1[i] % mod;
+			});
+			int t = sz(rec) - 1;
+			res = max(res, rec[t] == 0 ? t - 1 : t);
+		}
+		return res;
+	} /// end-hash
+};